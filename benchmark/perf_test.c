@@ -12,6 +12,9 @@
 #include <time.h>
 #include <inttypes.h>
 #include "hash_table.h"
+#include "hash_table_hash.h"
+#include "hash_table_int.h"
+#include "hash_table_typed.h"
 #include "hash_table_util.h"
 
 // SKEY macro for string keys
@@ -331,6 +334,398 @@ static void bench_memory_efficiency(size_t n) {
     hash_table_destroy(table);
 }
 
+// Benchmark: Split (parallel arrays) vs interleaved slot layout
+static void bench_layout(size_t n, hash_table_layout_t layout, const char *name) {
+    printf("\n=== %s Layout: %zu String Keys ===\n", name, n);
+    
+    hash_table_options_t options = hash_table_default_options();
+    options.layout = layout;
+    hash_table_t *table = hash_table_create_with_options(&options);
+    char key_buffer[64];
+    bench_timer_t timer;
+    
+    timer_start(&timer);
+    for (size_t i = 0; i < n; i++) {
+        generate_key((int)i, key_buffer, sizeof(key_buffer));
+        hash_table_insert_copy_string(table, key_buffer, &i, sizeof(size_t));
+    }
+    double insert_time = timer_end(&timer);
+    
+    size_t hits = 0;
+    timer_start(&timer);
+    for (size_t i = 0; i < n; i++) {
+        generate_key((int)i, key_buffer, sizeof(key_buffer));
+        if (hash_table_get_string(table, key_buffer)) hits++;
+    }
+    double hit_time = timer_end(&timer);
+    
+    timer_start(&timer);
+    for (size_t i = n; i < n * 2; i++) {
+        generate_key((int)i, key_buffer, sizeof(key_buffer));
+        if (hash_table_get_string(table, key_buffer)) hits++;
+    }
+    double miss_time = timer_end(&timer);
+    
+    printf("  Insert:      %.6f sec (%.0f ops/sec)\n", insert_time, n / insert_time);
+    printf("  Lookup hit:  %.6f sec (%.0f ops/sec)\n", hit_time, n / hit_time);
+    printf("  Lookup miss: %.6f sec (%.0f ops/sec)\n", miss_time, n / miss_time);
+    printf("  Found:       %zu/%zu keys\n", hits, n);
+    
+    hash_table_destroy(table);
+}
+
+// Worst-case insert latency while growing from the default capacity
+// Without incremental resize, the insert that crosses the threshold rehashes the whole table
+static void bench_insert_latency(size_t n, size_t migration_batch, const char *name) {
+    printf("\n=== Insert Latency, %s: %zu Keys ===\n", name, n);
+    
+    hash_table_options_t options = hash_table_default_options();
+    options.value_size = sizeof(uint64_t);
+    options.migration_batch = migration_batch;
+    hash_table_t *table = hash_table_create_with_options(&options);
+    bench_timer_t timer;
+    bench_timer_t op_timer;
+    double worst = 0.0;
+    size_t slow_inserts = 0;
+    
+    timer_start(&timer);
+    for (uint64_t i = 0; i < n; i++) {
+        timer_start(&op_timer);
+        hash_table_insert_copy(table, &i, sizeof(uint64_t), &i, sizeof(uint64_t));
+        double elapsed = timer_end(&op_timer);
+        if (elapsed > worst) worst = elapsed;
+        if (elapsed > 100e-6) slow_inserts++;
+    }
+    double total = timer_end(&timer);
+    
+    printf("  Total:        %.6f sec (%.0f ops/sec)\n", total, n / total);
+    printf("  Worst insert: %.3f ms\n", worst * 1e3);
+    printf("  Over 100 us:  %zu inserts\n", slow_inserts);
+    
+    hash_table_destroy(table);
+}
+
+HT_DEFINE(bench_u64_map, uint64_t, uint64_t, HT_HASH_INT, HT_EQ_SCALAR)
+
+// Generic table with 8-byte keys against the specialised integer and typed tables
+static void bench_integer_tables(size_t n) {
+    printf("\n=== Integer Tables: %zu Keys ===\n", n);
+    
+    bench_timer_t timer;
+    size_t hits = 0;
+    
+    hash_table_options_t options = hash_table_default_options();
+    options.value_size = sizeof(uint64_t);
+    hash_table_t *generic = hash_table_create_with_options(&options);
+    timer_start(&timer);
+    for (uint64_t i = 0; i < n; i++) {
+        hash_table_insert_copy(generic, &i, sizeof(uint64_t), &i, sizeof(uint64_t));
+    }
+    double generic_insert = timer_end(&timer);
+    timer_start(&timer);
+    for (uint64_t i = 0; i < n; i++) {
+        if (hash_table_get(generic, &i, sizeof(uint64_t))) hits++;
+    }
+    double generic_lookup = timer_end(&timer);
+    hash_table_destroy(generic);
+    
+    hash_table_u64_t *u64 = hash_table_u64_create();
+    timer_start(&timer);
+    for (uint64_t i = 0; i < n; i++) {
+        hash_table_u64_insert(u64, i, i);
+    }
+    double u64_insert = timer_end(&timer);
+    timer_start(&timer);
+    for (uint64_t i = 0; i < n; i++) {
+        if (hash_table_u64_get(u64, i)) hits++;
+    }
+    double u64_lookup = timer_end(&timer);
+    hash_table_u64_destroy(u64);
+    
+    hash_table_u32_t *u32 = hash_table_u32_create();
+    timer_start(&timer);
+    for (uint32_t i = 0; i < n; i++) {
+        hash_table_u32_insert(u32, i, i);
+    }
+    double u32_insert = timer_end(&timer);
+    timer_start(&timer);
+    for (uint32_t i = 0; i < n; i++) {
+        if (hash_table_u32_get(u32, i)) hits++;
+    }
+    double u32_lookup = timer_end(&timer);
+    hash_table_u32_destroy(u32);
+    
+    bench_u64_map_t *typed = bench_u64_map_create();
+    timer_start(&timer);
+    for (uint64_t i = 0; i < n; i++) {
+        bench_u64_map_insert(typed, i, i);
+    }
+    double typed_insert = timer_end(&timer);
+    timer_start(&timer);
+    for (uint64_t i = 0; i < n; i++) {
+        if (bench_u64_map_get(typed, i)) hits++;
+    }
+    double typed_lookup = timer_end(&timer);
+    bench_u64_map_destroy(typed);
+    
+    printf("  Generic insert: %.6f sec (%.0f ops/sec)\n", generic_insert, n / generic_insert);
+    printf("  Generic lookup: %.6f sec (%.0f ops/sec)\n", generic_lookup, n / generic_lookup);
+    printf("  u64 insert:     %.6f sec (%.0f ops/sec)\n", u64_insert, n / u64_insert);
+    printf("  u64 lookup:     %.6f sec (%.0f ops/sec)\n", u64_lookup, n / u64_lookup);
+    printf("  u32 insert:     %.6f sec (%.0f ops/sec)\n", u32_insert, n / u32_insert);
+    printf("  u32 lookup:     %.6f sec (%.0f ops/sec)\n", u32_lookup, n / u32_lookup);
+    printf("  Typed insert:   %.6f sec (%.0f ops/sec)\n", typed_insert, n / typed_insert);
+    printf("  Typed lookup:   %.6f sec (%.0f ops/sec)\n", typed_lookup, n / typed_lookup);
+    printf("  Found:          %zu/%zu keys\n", hits, 4 * n);
+}
+
+// Long string keys (about 60 bytes), where hashing dominates the lookup cost
+static void generate_long_key(size_t i, char *buffer, size_t size) {
+    snprintf(buffer, size, "tenant-%04zu/session/%010zu/attributes/preferences", i % 1000, i);
+}
+
+static void bench_hasher(size_t n, hash_function_t hasher, const char *name) {
+    printf("\n=== %s Hasher: %zu Long String Keys ===\n", name, n);
+    
+    hash_table_t *table = hash_table_create_with_hasher(hasher, NULL);
+    char key_buffer[96];
+    bench_timer_t timer;
+    
+    timer_start(&timer);
+    for (size_t i = 0; i < n; i++) {
+        generate_long_key(i, key_buffer, sizeof(key_buffer));
+        hash_table_insert_copy_string(table, key_buffer, &i, sizeof(size_t));
+    }
+    double insert_time = timer_end(&timer);
+    
+    size_t hits = 0;
+    timer_start(&timer);
+    for (size_t i = 0; i < n; i++) {
+        generate_long_key(i, key_buffer, sizeof(key_buffer));
+        if (hash_table_get_string(table, key_buffer)) hits++;
+    }
+    double hit_time = timer_end(&timer);
+    
+    timer_start(&timer);
+    for (size_t i = n; i < n * 2; i++) {
+        generate_long_key(i, key_buffer, sizeof(key_buffer));
+        if (hash_table_get_string(table, key_buffer)) hits++;
+    }
+    double miss_time = timer_end(&timer);
+    
+    printf("  Insert:      %.6f sec (%.0f ops/sec)\n", insert_time, n / insert_time);
+    printf("  Lookup hit:  %.6f sec (%.0f ops/sec)\n", hit_time, n / hit_time);
+    printf("  Lookup miss: %.6f sec (%.0f ops/sec)\n", miss_time, n / miss_time);
+    printf("  Found:       %zu/%zu keys\n", hits, n);
+    
+    hash_table_destroy(table);
+}
+
+// Out-of-line keys from individual mallocs against the key arena, dominated by teardown
+static void bench_key_arena(size_t n, size_t chunk_size, const char *name) {
+    printf("\n=== %s: %zu Long String Keys ===\n", name, n);
+    
+    hash_table_options_t options = hash_table_default_options();
+    options.value_size = sizeof(size_t);
+    options.key_arena_chunk_size = chunk_size;
+    hash_table_t *table = hash_table_create_with_options(&options);
+    char key_buffer[96];
+    bench_timer_t timer;
+    
+    timer_start(&timer);
+    for (size_t i = 0; i < n; i++) {
+        generate_long_key(i, key_buffer, sizeof(key_buffer));
+        hash_table_insert_copy_string(table, key_buffer, &i, sizeof(size_t));
+    }
+    double insert_time = timer_end(&timer);
+    
+    timer_start(&timer);
+    for (size_t i = 0; i < n; i += 2) {
+        generate_long_key(i, key_buffer, sizeof(key_buffer));
+        hash_table_remove_string(table, key_buffer);
+    }
+    double remove_time = timer_end(&timer);
+    
+    timer_start(&timer);
+    hash_table_destroy(table);
+    double destroy_time = timer_end(&timer);
+    
+    printf("  Insert:           %.6f sec (%.0f ops/sec)\n", insert_time, n / insert_time);
+    printf("  Remove half:      %.6f sec (%.0f ops/sec)\n", remove_time, (n / 2) / remove_time);
+    printf("  Destroy the rest: %.6f sec\n", destroy_time);
+}
+
+// Random lookups in a table much larger than the last level cache, where most lookups
+// miss the TLB unless the slot arrays sit on huge pages
+static void bench_huge_pages(size_t n, int huge_pages, const char *name) {
+    printf("\n=== %s: %zu Integer Keys ===\n", name, n);
+    
+    hash_table_options_t options = hash_table_default_options();
+    options.value_size = sizeof(uint64_t);
+    options.huge_pages = huge_pages;
+    hash_table_t *table = hash_table_create_with_options(&options);
+    bench_timer_t timer;
+    
+    timer_start(&timer);
+    for (uint64_t i = 0; i < n; i++) {
+        hash_table_insert_copy(table, &i, sizeof(uint64_t), &i, sizeof(uint64_t));
+    }
+    double insert_time = timer_end(&timer);
+    
+    uint64_t state = 88172645463325252ull;
+    size_t hits = 0;
+    timer_start(&timer);
+    for (size_t i = 0; i < n; i++) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        uint64_t key = state % n;
+        if (hash_table_get(table, &key, sizeof(uint64_t))) hits++;
+    }
+    double lookup_time = timer_end(&timer);
+    
+    printf("  Mapped slots:  %s\n", table->_slots_mapped ? "yes" : "no");
+    printf("  Insert:        %.6f sec (%.0f ops/sec)\n", insert_time, n / insert_time);
+    printf("  Random lookup: %.6f sec (%.0f ops/sec)\n", lookup_time, n / lookup_time);
+    printf("  Found:         %zu/%zu keys\n", hits, n);
+    
+    hash_table_destroy(table);
+}
+
+// Random lookups in a table larger than the last level cache, one get per key (batch_size 0)
+// or batch_size keys per hash_table_get_batch call
+static void bench_get_batch(size_t n, size_t batch_size, const char *name) {
+    printf("\n=== %s: %zu Random Lookups ===\n", name, n);
+    
+    hash_table_options_t options = hash_table_default_options();
+    options.value_size = sizeof(uint64_t);
+    hash_table_t *table = hash_table_create_with_options(&options);
+    for (uint64_t i = 0; i < n; i++) {
+        hash_table_insert_copy(table, &i, sizeof(uint64_t), &i, sizeof(uint64_t));
+    }
+    
+    uint64_t *keys = malloc(n * sizeof(uint64_t));
+    const void **key_ptrs = malloc(n * sizeof(void *));
+    size_t *key_sizes = malloc(n * sizeof(size_t));
+    void **values = malloc(n * sizeof(void *));
+    uint64_t state = 88172645463325252ull;
+    for (size_t i = 0; i < n; i++) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        keys[i] = state % n;
+        key_ptrs[i] = &keys[i];
+        key_sizes[i] = sizeof(uint64_t);
+    }
+    
+    bench_timer_t timer;
+    size_t hits = 0;
+    timer_start(&timer);
+    if (batch_size == 0) {
+        for (size_t i = 0; i < n; i++) {
+            values[i] = hash_table_get(table, &keys[i], sizeof(uint64_t));
+            hits += values[i] != NULL;
+        }
+    } else {
+        for (size_t i = 0; i < n; i += batch_size) {
+            size_t count = n - i < batch_size ? n - i : batch_size;
+            hits += hash_table_get_batch(table, key_ptrs + i, key_sizes + i, count, values + i);
+        }
+    }
+    double lookup_time = timer_end(&timer);
+    
+    printf("  Lookup: %.6f sec (%.0f ops/sec)\n", lookup_time, n / lookup_time);
+    printf("  Found:  %zu/%zu keys\n", hits, n);
+    
+    free(keys);
+    free(key_ptrs);
+    free(key_sizes);
+    free(values);
+    hash_table_destroy(table);
+}
+
+// Bulk load of n integer keys into an empty table, one insert_copy per key (batch_size 0)
+// or batch_size keys per hash_table_insert_batch call
+static void bench_insert_batch(size_t n, size_t batch_size, const char *name) {
+    printf("\n=== %s: %zu Integer Keys ===\n", name, n);
+    
+    uint64_t *keys = malloc(n * sizeof(uint64_t));
+    const void **key_ptrs = malloc(n * sizeof(void *));
+    size_t *key_sizes = malloc(n * sizeof(size_t));
+    uint64_t state = 88172645463325252ull;
+    for (size_t i = 0; i < n; i++) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        keys[i] = state;
+        key_ptrs[i] = &keys[i];
+        key_sizes[i] = sizeof(uint64_t);
+    }
+    
+    hash_table_options_t options = hash_table_default_options();
+    options.value_size = sizeof(uint64_t);
+    hash_table_t *table = hash_table_create_with_options(&options);
+    bench_timer_t timer;
+    
+    timer_start(&timer);
+    if (batch_size == 0) {
+        for (size_t i = 0; i < n; i++) {
+            hash_table_insert_copy(table, &keys[i], sizeof(uint64_t), &keys[i], sizeof(uint64_t));
+        }
+    } else {
+        for (size_t i = 0; i < n; i += batch_size) {
+            size_t count = n - i < batch_size ? n - i : batch_size;
+            hash_table_insert_batch(table, key_ptrs + i, key_sizes + i, key_ptrs + i, sizeof(uint64_t), count, NULL);
+        }
+    }
+    double insert_time = timer_end(&timer);
+    
+    printf("  Insert: %.6f sec (%.0f ops/sec)\n", insert_time, n / insert_time);
+    printf("  Size:   %zu (capacity %zu)\n", hash_table_size(table), hash_table_capacity(table));
+    
+    free(keys);
+    free(key_ptrs);
+    free(key_sizes);
+    hash_table_destroy(table);
+}
+
+// Check-then-insert of n long string keys (each key inserted once, then every key again),
+// hashing each key per call or once with hash_table_hash
+static void bench_prehashed(size_t n, int prehashed, const char *name) {
+    printf("\n=== %s: %zu Long String Keys ===\n", name, n);
+    
+    hash_table_options_t options = hash_table_default_options();
+    options.value_size = sizeof(size_t);
+    hash_table_t *table = hash_table_create_with_options(&options);
+    bench_timer_t timer;
+    char key[96];
+    size_t inserted = 0;
+    
+    timer_start(&timer);
+    for (size_t round = 0; round < 2; round++) {
+        for (size_t i = 0; i < n; i++) {
+            generate_long_key(i, key, sizeof(key));
+            size_t key_size = strlen(key) + 1;
+            if (prehashed) {
+                size_t hash = hash_table_hash(table, key, key_size);
+                if (!hash_table_contains_prehashed(table, key, key_size, hash)) {
+                    hash_table_insert_copy_prehashed(table, key, key_size, hash, &i, sizeof(size_t));
+                    inserted++;
+                }
+            } else if (!hash_table_contains(table, key, key_size)) {
+                hash_table_insert_copy(table, key, key_size, &i, sizeof(size_t));
+                inserted++;
+            }
+        }
+    }
+    double time = timer_end(&timer);
+    
+    printf("  Check and insert: %.6f sec (%.0f ops/sec)\n", time, 2 * n / time);
+    printf("  Inserted:         %zu keys\n", inserted);
+    
+    hash_table_destroy(table);
+}
+
 int main(void) {
     printf("========================================\n");
     printf("Hash Table Performance Benchmarks\n");
@@ -370,6 +765,71 @@ int main(void) {
         bench_memory_efficiency(n);
     }
     
+    printf("\n\n");
+    printf("========================================\n");
+    printf("LAYOUT COMPARISON: 1000000 entries\n");
+    printf("========================================\n");
+    bench_layout(1000000, HASH_TABLE_LAYOUT_SPLIT, "Split");
+    bench_layout(1000000, HASH_TABLE_LAYOUT_INTERLEAVED, "Interleaved");
+    
+    printf("\n\n");
+    printf("========================================\n");
+    printf("HASH FUNCTION COMPARISON: 1000000 entries\n");
+    printf("========================================\n");
+    bench_hasher(1000000, hash_table_hash_fnv_1a, "FNV-1a");
+    bench_hasher(1000000, hash_table_hash_wyhash, "wyhash");
+    bench_hasher(1000000, hash_table_hash_crc32c, "CRC32C");
+    
+    printf("\n\n");
+    printf("========================================\n");
+    printf("INTEGER KEYS: 1000000 entries\n");
+    printf("========================================\n");
+    bench_integer_tables(1000000);
+    
+    printf("\n\n");
+    printf("========================================\n");
+    printf("INSERT TAIL LATENCY: 4000000 entries\n");
+    printf("========================================\n");
+    bench_insert_latency(4000000, 0, "Stop-the-world Resize");
+    bench_insert_latency(4000000, HASH_TABLE_DEFAULT_MIGRATION_BATCH, "Incremental Resize");
+    
+    printf("\n\n");
+    printf("========================================\n");
+    printf("KEY ARENA: 5000000 entries\n");
+    printf("========================================\n");
+    bench_key_arena(5000000, 0, "malloc per Key");
+    bench_key_arena(5000000, HASH_TABLE_DEFAULT_KEY_ARENA_CHUNK_SIZE, "Key Arena");
+    
+    printf("\n\n");
+    printf("========================================\n");
+    printf("HUGE PAGES: 8000000 entries (656 MB of slots)\n");
+    printf("========================================\n");
+    bench_huge_pages(8000000, 0, "Allocator Slots");
+    bench_huge_pages(8000000, 1, "Huge Page Slots");
+    
+    printf("\n\n");
+    printf("========================================\n");
+    printf("BATCHED LOOKUP: 8000000 entries\n");
+    printf("========================================\n");
+    bench_get_batch(8000000, 0, "Single get");
+    bench_get_batch(8000000, 64, "get_batch x64");
+    bench_get_batch(8000000, 512, "get_batch x512");
+    
+    printf("\n\n");
+    printf("========================================\n");
+    printf("BATCHED INSERT: 8000000 entries\n");
+    printf("========================================\n");
+    bench_insert_batch(8000000, 0, "Single insert_copy");
+    bench_insert_batch(8000000, 8000000, "insert_batch, one batch");
+    bench_insert_batch(8000000, 4096, "insert_batch x4096");
+    
+    printf("\n\n");
+    printf("========================================\n");
+    printf("PREHASHED CHECK-THEN-INSERT: 1000000 entries\n");
+    printf("========================================\n");
+    bench_prehashed(1000000, 0, "contains + insert_copy");
+    bench_prehashed(1000000, 1, "hash_table_hash + prehashed");
+    
     printf("\n\n");
     printf("========================================\n");
     printf("All benchmarks completed successfully!\n");
@@ -1,19 +1,108 @@
+// mremap and MAP_ANONYMOUS are extensions
+#define _GNU_SOURCE
+
 #include "hash_table.h"
+#include "hash_table_group.h"
+#include "hash_table_hash.h"
 #include "hash_table_util.h"
 
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <limits.h>
 #include <assert.h>
 
+#ifdef __linux__
+#include <sys/mman.h>
+#define HASH_TABLE_HAVE_MMAP 1
+#endif
+
+// Returned by probe functions when the key is not in the table
+#define HASH_TABLE_NOT_FOUND SIZE_MAX
+
+// One slot of the interleaved layout
+// Also used to carry a slot's contents between tables of either layout
+struct hash_table_slot {
+    size_t hash;        // Hash of the key
+    size_t key_size;    // Key size in bytes
+    hash_table_key_t key; // Owned copy of the key
+    void *value;        // Value
+};
+
+// Chunk of key arena memory, keys are bump-allocated from data
+typedef struct hash_table_key_arena_chunk {
+    struct hash_table_key_arena_chunk *next; // Next (older) chunk
+    size_t used;                             // Bytes handed out from data
+    size_t capacity;                         // Bytes in data
+    _Alignas(max_align_t) unsigned char data[];
+} hash_table_key_arena_chunk_t;
+
 // Forward declarations for static functions
 static int hash_table_resize(hash_table_t *table, size_t new_capacity);
-static size_t hash_table_fnv_1a(const void *key, size_t key_size);
+static size_t hash_table_probe(const hash_table_t *table, const void *key, size_t key_size, size_t hash, size_t *free_slot);
+static size_t hash_table_find_free(const hash_table_t *table, size_t hash);
+static int hash_table_alloc_slots(hash_table_t *table, size_t capacity);
+static void hash_table_free_slots(hash_table_t *table);
+static void hash_table_rehash_in_place(hash_table_t *table);
+static void hash_table_place_pending(hash_table_t *table);
+static int hash_table_rebuild(hash_table_t *table, size_t new_capacity);
+static void hash_table_migrate_step(hash_table_t *table);
+static void hash_table_migrate_key(hash_table_t *table, const void *key, size_t key_size, size_t hash);
+static void hash_table_finish_migration(hash_table_t *table);
+static int hash_table_start_migration(hash_table_t *table, size_t new_capacity);
+static void hash_table_clear_entries(hash_table_t *table);
+static void hash_table_key_arena_free_chunks(hash_table_key_arena_t *arena, hash_table_key_arena_chunk_t *chunk);
 
 const size_t HASH_TABLE_DEFAULT_INITIAL_CAPACITY = 16;
 const float HASH_TABLE_DEFAULT_RESIZE_THRESHOLD = 0.5f;
 const float HASH_TABLE_DEFAULT_RESIZE_FACTOR = 2.0f;
+const float HASH_TABLE_ROBIN_HOOD_RESIZE_THRESHOLD = 0.875f;
+const float HASH_TABLE_DEFAULT_TOMBSTONE_THRESHOLD = 0.25f;
+const size_t HASH_TABLE_DEFAULT_MAX_PROBE_LENGTH = 128;
+const size_t HASH_TABLE_DEFAULT_MIGRATION_BATCH = 64;
+const float HASH_TABLE_DEFAULT_SHRINK_THRESHOLD = 0.125f;
+const size_t HASH_TABLE_DEFAULT_KEY_ARENA_CHUNK_SIZE = 64 * 1024;
+
+// ============================================================================
+// Allocation
+// ============================================================================
+
+static void *hash_table_stdlib_allocate(size_t size, void *context) {
+    (void)context;
+    return malloc(size);
+}
+
+static void hash_table_stdlib_release(void *ptr, void *context) {
+    (void)context;
+    free(ptr);
+}
+
+static const hash_table_allocator_t hash_table_stdlib_allocator = {
+    hash_table_stdlib_allocate,
+    hash_table_stdlib_release,
+    NULL
+};
+
+static inline void *hash_table_allocate(const hash_table_allocator_t *allocator, size_t size) {
+    return allocator->allocate(size, allocator->context);
+}
+
+// Zero-filled array of count elements (like calloc), NULL on failure or overflow
+static void *hash_table_allocate_zeroed(const hash_table_allocator_t *allocator, size_t count, size_t size) {
+    if (size != 0 && count > SIZE_MAX / size) return NULL;
+    void *ptr = allocator->allocate(count * size, allocator->context);
+    if (ptr != NULL) {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
+
+static inline void hash_table_release(const hash_table_allocator_t *allocator, void *ptr) {
+    if (ptr != NULL) {
+        allocator->release(ptr, allocator->context);
+    }
+}
 
 hash_table_t *hash_table_create() {
     return hash_table_create_with_parameters_and_destructor(
@@ -38,42 +127,758 @@ hash_table_t *hash_table_create_with_parameters(size_t capacity, float resize_th
 }
 
 hash_table_t *hash_table_create_with_parameters_and_destructor(size_t capacity, float resize_threshold, float resize_factor, value_destructor_t destructor) {
-    hash_table_t *table = malloc(sizeof(hash_table_t));
+    hash_table_options_t options = hash_table_default_options();
+    options.initial_capacity = capacity;
+    options.resize_threshold = resize_threshold;
+    options.resize_factor = resize_factor;
+    options.value_destructor = destructor;
+    return hash_table_create_with_options(&options);
+}
+
+hash_table_t *hash_table_create_with_hasher(hash_function_t hasher, void *context) {
+    hash_table_options_t options = hash_table_default_options();
+    options.hash_function = hasher;
+    options.hash_context = context;
+    return hash_table_create_with_options(&options);
+}
+
+hash_table_t *hash_table_create_with_allocator(const hash_table_allocator_t *allocator) {
+    hash_table_options_t options = hash_table_default_options();
+    options.allocator = allocator;
+    return hash_table_create_with_options(&options);
+}
+
+hash_table_options_t hash_table_default_options(void) {
+    hash_table_options_t options;
+    options.initial_capacity = HASH_TABLE_DEFAULT_INITIAL_CAPACITY;
+    options.resize_threshold = HASH_TABLE_DEFAULT_RESIZE_THRESHOLD;
+    options.resize_factor = HASH_TABLE_DEFAULT_RESIZE_FACTOR;
+    options.value_destructor = NULL;
+    options.layout = HASH_TABLE_LAYOUT_SPLIT;
+    options.value_size = 0;
+    options.probing = HASH_TABLE_PROBING_LINEAR;
+    options.deletion = HASH_TABLE_DELETION_BACKWARD_SHIFT;
+    options.tombstone_threshold = HASH_TABLE_DEFAULT_TOMBSTONE_THRESHOLD;
+    options.hash_function = hash_table_hash_fnv_1a;
+    options.hash_context = NULL;
+    options.seed = 0;
+    options.random_seed = 0;
+    options.max_probe_length = 0;
+    options.key_equal = NULL;
+    options.migration_batch = 0;
+    options.shrink_threshold = 0.0f;
+    options.key_arena_chunk_size = 0;
+    options.allocator = NULL;
+    options.huge_pages = 0;
+    return options;
+}
+
+hash_table_t *hash_table_create_with_options(const hash_table_options_t *options) {
+    if (options == NULL) return NULL;
+
+    const hash_table_allocator_t *allocator = options->allocator != NULL ? options->allocator : &hash_table_stdlib_allocator;
+    hash_table_t *table = hash_table_allocate(allocator, sizeof(hash_table_t));
+    if (table == NULL) return NULL;
+    table->_allocator = *allocator;
     table->size = 0;
-    table->capacity = capacity;
-    table->_resize_threshold = resize_threshold;
-    table->_resize_factor = resize_factor;
-    table->_value_destructor = destructor;
-    table->keys = calloc(table->capacity, sizeof(void *));
-    table->key_sizes = calloc(table->capacity, sizeof(size_t));
-    table->values = calloc(table->capacity, sizeof(void *));
+    table->_resize_threshold = options->resize_threshold;
+    table->_resize_factor = options->resize_factor;
+    table->_value_destructor = options->value_destructor;
+    table->_layout = options->layout;
+    table->_value_size = options->value_size;
+    table->_value_scratch = NULL;
+    table->_probing = options->probing;
+    table->_deletion = options->deletion;
+    table->_tombstone_threshold = options->tombstone_threshold;
+    table->_hash_function = options->hash_function != NULL ? options->hash_function : hash_table_hash_fnv_1a;
+    table->_hash_context = options->hash_context;
+    table->_seed = options->random_seed ? hash_table_random_seed() : options->seed;
+    table->_max_probe_length = options->max_probe_length;
+    table->_probe_limit = options->max_probe_length;
+    table->_key_equal = options->key_equal;
+    table->_old = NULL;
+    table->_migration_batch = options->migration_batch;
+    table->_migrate_index = 0;
+    table->_shrink_threshold = options->shrink_threshold;
+    table->_huge_pages = options->huge_pages;
+    table->_key_arena = NULL;
+    if (options->key_arena_chunk_size != 0) {
+        table->_key_arena = hash_table_allocate_zeroed(allocator, 1, sizeof(hash_table_key_arena_t));
+        if (table->_key_arena == NULL) {
+            hash_table_release(allocator, table);
+            return NULL;
+        }
+        table->_key_arena->chunk_size = options->key_arena_chunk_size;
+        table->_key_arena->allocator = *allocator;
+    }
+    if (table->_value_size != 0) {
+        table->_value_scratch = hash_table_allocate(allocator, 2 * table->_value_size);
+        if (table->_value_scratch == NULL) {
+            hash_table_release(allocator, table->_key_arena);
+            hash_table_release(allocator, table);
+            return NULL;
+        }
+    }
+    if (hash_table_alloc_slots(table, options->initial_capacity) != 0) {
+        hash_table_release(allocator, table->_value_scratch);
+        hash_table_release(allocator, table->_key_arena);
+        hash_table_release(allocator, table);
+        return NULL;
+    }
+    table->_min_capacity = table->capacity;
     return table;
 }
 
 void hash_table_destroy(hash_table_t *table) {
     if (table == NULL) return;
-    hash_table_clear(table);
-    free(table->keys);
-    free(table->key_sizes);
-    free(table->values);
-    free(table);
+    hash_table_clear_entries(table);
+    hash_table_free_slots(table);
+    hash_table_allocator_t allocator = table->_allocator;
+    if (table->_key_arena != NULL) {
+        hash_table_key_arena_free_chunks(table->_key_arena, table->_key_arena->chunks);
+        hash_table_release(&allocator, table->_key_arena);
+    }
+    hash_table_release(&allocator, table->_value_scratch);
+    hash_table_release(&allocator, table);
 }
 
-void hash_table_clear(hash_table_t *table) {
-    if (table == NULL) return;
-    for (size_t i = 0; i < table->capacity; i++) {
-        if (table->keys[i] != NULL) {
-            free(table->keys[i]);
-            if (table->_value_destructor != NULL) {
-                table->_value_destructor(table->values[i]);
-            } else {
-                free(table->values[i]);
+// Hash a key with the table's hash function, seed and context
+static inline size_t hash_table_hash_key(const hash_table_t *table, const void *key, size_t key_size) {
+    return table->_hash_function(key, key_size, table->_seed, table->_hash_context);
+}
+
+static inline int hash_table_is_power_of_two(size_t n) {
+    return n != 0 && (n & (n - 1)) == 0;
+}
+
+// Set the capacity and the indexing parameters derived from it
+static void hash_table_set_capacity(hash_table_t *table, size_t capacity) {
+    table->capacity = capacity;
+    table->_mask = 0;
+    table->_hash_shift = 0;
+    if (hash_table_is_power_of_two(capacity)) {
+        unsigned bits = 0;
+        while (((size_t)1 << bits) < capacity) {
+            bits++;
+        }
+        // Keep the shift below the word width, the mask handles capacity 1
+        table->_mask = capacity - 1;
+        table->_hash_shift = (unsigned)(sizeof(size_t) * CHAR_BIT) - (bits > 0 ? bits : 1);
+    }
+}
+
+// ============================================================================
+// Occupancy Bitmap
+// ============================================================================
+// One bit per slot, set while the slot is full. hash_table_set_ctrl keeps it in sync with
+// the control bytes; loops over every entry use it to skip 64 non-full slots per word,
+// so they cost O(entries + capacity / 64) instead of O(capacity).
+
+// Words of the bitmap for a capacity (at least one, bits past the capacity stay clear)
+static inline size_t hash_table_occupied_words(size_t capacity) {
+    return capacity / 64 + 1;
+}
+
+// Index of the lowest set bit (bits must be non-zero)
+static inline unsigned hash_table_ctz64(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctzll(bits);
+#else
+    unsigned index = 0;
+    while ((bits & 1u) == 0) {
+        bits >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+// First full slot at or after index, or the capacity if there is none
+static inline size_t hash_table_next_occupied(const hash_table_t *table, size_t index) {
+    if (index >= table->capacity) return table->capacity;
+    size_t word = index / 64;
+    uint64_t bits = table->occupied[word] & (~(uint64_t)0 << (index % 64));
+    while (bits == 0) {
+        if (++word >= hash_table_occupied_words(table->capacity)) return table->capacity;
+        bits = table->occupied[word];
+    }
+    return word * 64 + hash_table_ctz64(bits);
+}
+
+// ============================================================================
+// Slot Storage
+// ============================================================================
+// With options.huge_pages, storage of at least HASH_TABLE_MAP_THRESHOLD bytes is mapped
+// with mmap and madvise(MADV_HUGEPAGE) instead of coming from the allocator, so large
+// tables take one TLB entry per 2 MiB instead of per 4 KiB page. Mapped memory is already
+// zeroed, and growing a mapped linear probing table extends the arrays with mremap and
+// rehashes in place instead of allocating, copying and freeing a second storage.
+// Without mmap (or if mapping fails) the storage quietly comes from the allocator.
+
+// Smallest storage worth mapping (one huge page)
+#ifndef HASH_TABLE_MAP_THRESHOLD
+#define HASH_TABLE_MAP_THRESHOLD ((size_t)2 * 1024 * 1024)
+#endif
+
+// Number of storage arrays, in the order used by hash_table_storage_arrays
+#define HASH_TABLE_STORAGE_ARRAYS 7
+
+#ifdef HASH_TABLE_HAVE_MMAP
+static void *hash_table_map(size_t bytes) {
+    void *ptr = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) return NULL;
+#ifdef MADV_HUGEPAGE
+    // Only a hint: without transparent huge pages this fails and regular pages are used
+    madvise(ptr, bytes, MADV_HUGEPAGE);
+#endif
+    return ptr;
+}
+
+static void *hash_table_remap(void *ptr, size_t old_bytes, size_t new_bytes) {
+    void *grown = mremap(ptr, old_bytes, new_bytes, MREMAP_MAYMOVE);
+    if (grown == MAP_FAILED) return NULL;
+#ifdef MADV_HUGEPAGE
+    madvise(grown, new_bytes, MADV_HUGEPAGE);
+#endif
+    return grown;
+}
+
+static void hash_table_unmap(void *ptr, size_t bytes) {
+    munmap(ptr, bytes);
+}
+#else
+static void *hash_table_map(size_t bytes) {
+    (void)bytes;
+    return NULL;
+}
+
+static void *hash_table_remap(void *ptr, size_t old_bytes, size_t new_bytes) {
+    (void)ptr;
+    (void)old_bytes;
+    (void)new_bytes;
+    return NULL;
+}
+
+static void hash_table_unmap(void *ptr, size_t bytes) {
+    (void)ptr;
+    (void)bytes;
+}
+#endif
+
+// Bytes of one storage array for a capacity (the control bytes have the mirrored tail)
+static inline size_t hash_table_array_bytes(size_t capacity, size_t array, size_t bytes_per_slot) {
+    return capacity * bytes_per_slot + (array == 0 ? HASH_TABLE_GROUP_WIDTH - 1 : 0);
+}
+
+// The storage arrays (NULL when the layout does not use them) and their bytes per slot
+static void hash_table_storage_arrays(const hash_table_t *table, void *arrays[], size_t bytes_per_slot[]) {
+    arrays[0] = table->ctrl;       bytes_per_slot[0] = 1;
+    arrays[1] = table->hashes;     bytes_per_slot[1] = sizeof(size_t);
+    arrays[2] = table->keys;       bytes_per_slot[2] = sizeof(hash_table_key_t);
+    arrays[3] = table->key_sizes;  bytes_per_slot[3] = sizeof(size_t);
+    arrays[4] = table->values;     bytes_per_slot[4] = sizeof(void *);
+    arrays[5] = table->slots;      bytes_per_slot[5] = sizeof(hash_table_slot_t);
+    arrays[6] = table->value_data; bytes_per_slot[6] = table->_value_size;
+}
+
+static void hash_table_set_storage_arrays(hash_table_t *table, void *const arrays[]) {
+    table->ctrl = arrays[0];
+    table->hashes = arrays[1];
+    table->keys = arrays[2];
+    table->key_sizes = arrays[3];
+    table->values = arrays[4];
+    table->slots = arrays[5];
+    table->value_data = arrays[6];
+}
+
+// Zero-filled array for the table's storage, mapped or from the allocator
+static void *hash_table_alloc_array(const hash_table_t *table, size_t count, size_t size) {
+    if (table->_slots_mapped) {
+        if (size != 0 && count > SIZE_MAX / size) return NULL;
+        return hash_table_map(count * size);
+    }
+    return hash_table_allocate_zeroed(&table->_allocator, count, size);
+}
+
+// Allocate empty slot storage of the given capacity for the table's layout
+// Overwrites the storage pointers without freeing them
+// Returns 0 on success, 1 on failure (nothing stays allocated)
+static int hash_table_alloc_slots(hash_table_t *table, size_t capacity) {
+    hash_table_set_capacity(table, capacity);
+
+    size_t bytes_per_slot = 1 + table->_value_size;
+    if (table->_layout == HASH_TABLE_LAYOUT_INTERLEAVED) {
+        bytes_per_slot += sizeof(hash_table_slot_t);
+    } else {
+        bytes_per_slot += 2 * sizeof(size_t) + sizeof(hash_table_key_t) + (table->_value_size == 0 ? sizeof(void *) : 0);
+    }
+    table->_slots_mapped = table->_huge_pages && capacity >= HASH_TABLE_MAP_THRESHOLD / bytes_per_slot;
+
+    for (;;) {
+        table->ctrl = hash_table_alloc_array(table, capacity + HASH_TABLE_GROUP_WIDTH - 1, 1);
+        table->occupied = hash_table_allocate_zeroed(&table->_allocator, hash_table_occupied_words(capacity), sizeof(uint64_t));
+        table->hashes = NULL;
+        table->keys = NULL;
+        table->key_sizes = NULL;
+        table->values = NULL;
+        table->slots = NULL;
+        table->value_data = NULL;
+
+        int failed = table->ctrl == NULL || table->occupied == NULL;
+        if (table->_layout == HASH_TABLE_LAYOUT_INTERLEAVED) {
+            table->slots = hash_table_alloc_array(table, capacity, sizeof(hash_table_slot_t));
+            failed = failed || table->slots == NULL;
+        } else {
+            table->hashes = hash_table_alloc_array(table, capacity, sizeof(size_t));
+            table->keys = hash_table_alloc_array(table, capacity, sizeof(hash_table_key_t));
+            table->key_sizes = hash_table_alloc_array(table, capacity, sizeof(size_t));
+            failed = failed || table->hashes == NULL || table->keys == NULL || table->key_sizes == NULL;
+            if (table->_value_size == 0) {
+                table->values = hash_table_alloc_array(table, capacity, sizeof(void *));
+                failed = failed || table->values == NULL;
+            }
+        }
+        if (table->_value_size != 0) {
+            table->value_data = hash_table_alloc_array(table, capacity, table->_value_size);
+            failed = failed || table->value_data == NULL;
+        }
+
+        if (!failed) break;
+        hash_table_free_slots(table);
+        if (!table->_slots_mapped) return 1;
+        // Mapping failed, fall back to the allocator
+        table->_slots_mapped = 0;
+    }
+    memset(table->ctrl, HASH_TABLE_CTRL_EMPTY, capacity + HASH_TABLE_GROUP_WIDTH - 1);
+    table->_tombstones = 0;
+    return 0;
+}
+
+// Free the slot storage (not the keys and values it refers to)
+static void hash_table_free_slots(hash_table_t *table) {
+    // The bitmap is small, so it always comes from the allocator, even for mapped storage
+    hash_table_release(&table->_allocator, table->occupied);
+    table->occupied = NULL;
+
+    void *arrays[HASH_TABLE_STORAGE_ARRAYS];
+    size_t bytes_per_slot[HASH_TABLE_STORAGE_ARRAYS];
+    hash_table_storage_arrays(table, arrays, bytes_per_slot);
+    for (size_t i = 0; i < HASH_TABLE_STORAGE_ARRAYS; i++) {
+        if (arrays[i] == NULL) continue;
+        if (table->_slots_mapped) {
+            hash_table_unmap(arrays[i], hash_table_array_bytes(table->capacity, i, bytes_per_slot[i]));
+        } else {
+            hash_table_release(&table->_allocator, arrays[i]);
+        }
+        arrays[i] = NULL;
+    }
+    hash_table_set_storage_arrays(table, arrays);
+}
+
+// Grow mapped storage to new_capacity with mremap, then rehash the entries in place
+// Linear probing only, since the in-place rehash does not keep Robin Hood order
+// Returns 0 on success, 1 if the storage is not mapped or cannot be remapped (the table is unchanged)
+static int hash_table_grow_mapped(hash_table_t *table, size_t new_capacity) {
+    if (!table->_slots_mapped || table->_probing != HASH_TABLE_PROBING_LINEAR) return 1;
+
+    // Starts empty: placing the pending entries below sets the bit of every full slot
+    uint64_t *occupied = hash_table_allocate_zeroed(&table->_allocator, hash_table_occupied_words(new_capacity), sizeof(uint64_t));
+    if (occupied == NULL) return 1;
+
+    void *arrays[HASH_TABLE_STORAGE_ARRAYS];
+    size_t bytes_per_slot[HASH_TABLE_STORAGE_ARRAYS];
+    hash_table_storage_arrays(table, arrays, bytes_per_slot);
+    size_t old_capacity = table->capacity;
+
+    for (size_t i = 0; i < HASH_TABLE_STORAGE_ARRAYS; i++) {
+        if (arrays[i] == NULL) continue;
+        void *grown = hash_table_remap(arrays[i], hash_table_array_bytes(old_capacity, i, bytes_per_slot[i]),
+                                       hash_table_array_bytes(new_capacity, i, bytes_per_slot[i]));
+        if (grown == NULL) {
+            // Shrinking back in place cannot fail, so the table ends up as it was
+            while (i-- > 0) {
+                if (arrays[i] == NULL) continue;
+                arrays[i] = hash_table_remap(arrays[i], hash_table_array_bytes(new_capacity, i, bytes_per_slot[i]),
+                                             hash_table_array_bytes(old_capacity, i, bytes_per_slot[i]));
+            }
+            hash_table_set_storage_arrays(table, arrays);
+            hash_table_release(&table->_allocator, occupied);
+            return 1;
+        }
+        arrays[i] = grown;
+    }
+    hash_table_set_storage_arrays(table, arrays);
+    hash_table_release(&table->_allocator, table->occupied);
+    table->occupied = occupied;
+
+    // The grown part is zeroed like a fresh mapping, only the control bytes need setting
+    // Entries are marked pending for the in-place rehash, which then spreads them out
+    for (size_t i = 0; i < old_capacity; i++) {
+        table->ctrl[i] = hash_table_ctrl_is_full(table->ctrl[i]) ? HASH_TABLE_CTRL_DELETED : HASH_TABLE_CTRL_EMPTY;
+    }
+    memset(table->ctrl + old_capacity, HASH_TABLE_CTRL_EMPTY, new_capacity - old_capacity + HASH_TABLE_GROUP_WIDTH - 1);
+    hash_table_set_capacity(table, new_capacity);
+    hash_table_place_pending(table);
+    return 0;
+}
+
+// Home slot of a hash
+// Power-of-two tables take the high bits of a Fibonacci (multiplicative) mix,
+// which spreads hashes whose entropy sits in the low bits
+static inline size_t hash_table_home(const hash_table_t *table, size_t hash) {
+    if (table->_hash_shift != 0) {
+        return ((hash * HASH_TABLE_FIBONACCI_MULTIPLIER) >> table->_hash_shift) & table->_mask;
+    }
+    return hash % table->capacity;
+}
+
+// Distance of a slot from the home slot of the hash stored in it
+static inline size_t hash_table_distance(const hash_table_t *table, size_t index, size_t hash) {
+    size_t home = hash_table_home(table, hash);
+    return index >= home ? index - home : index + table->capacity - home;
+}
+
+// Wrap a slot index that may have run past the end of the table
+static inline size_t hash_table_wrap(const hash_table_t *table, size_t index) {
+    if (table->_hash_shift != 0) {
+        return index & table->_mask;
+    }
+    while (index >= table->capacity) {
+        index -= table->capacity;
+    }
+    return index;
+}
+
+// Set a control byte, keeping the mirrored bytes past the end, the occupancy bitmap and the
+// tombstone count in sync
+static void hash_table_set_ctrl(hash_table_t *table, size_t index, uint8_t ctrl) {
+    table->_tombstones -= table->ctrl[index] == HASH_TABLE_CTRL_DELETED;
+    table->_tombstones += ctrl == HASH_TABLE_CTRL_DELETED;
+    table->ctrl[index] = ctrl;
+    uint64_t *word = &table->occupied[index / 64];
+    *word = (*word & ~((uint64_t)1 << (index % 64))) | ((uint64_t)hash_table_ctrl_is_full(ctrl) << (index % 64));
+    for (size_t mirror = index; mirror < HASH_TABLE_GROUP_WIDTH - 1; mirror += table->capacity) {
+        table->ctrl[table->capacity + mirror] = ctrl;
+    }
+}
+
+// ============================================================================
+// Slot Accessors
+// ============================================================================
+// All slot data goes through these so the rest of the code is layout agnostic
+
+static inline size_t hash_table_slot_hash(const hash_table_t *table, size_t index) {
+    return table->_layout == HASH_TABLE_LAYOUT_INTERLEAVED ? table->slots[index].hash : table->hashes[index];
+}
+
+static inline size_t hash_table_slot_key_size(const hash_table_t *table, size_t index) {
+    return table->_layout == HASH_TABLE_LAYOUT_INTERLEAVED ? table->slots[index].key_size : table->key_sizes[index];
+}
+
+static inline hash_table_key_t *hash_table_slot_key_ref(const hash_table_t *table, size_t index) {
+    return table->_layout == HASH_TABLE_LAYOUT_INTERLEAVED ? &table->slots[index].key : &table->keys[index];
+}
+
+// Pointer to a stored key's bytes, wherever they live
+static inline const void *hash_table_key_data(const hash_table_key_t *key, size_t key_size) {
+    return key_size <= HASH_TABLE_INLINE_KEY_SIZE ? (const void *)key->bytes : key->ptr;
+}
+
+static inline const void *hash_table_slot_key(const hash_table_t *table, size_t index) {
+    return hash_table_key_data(hash_table_slot_key_ref(table, index), hash_table_slot_key_size(table, index));
+}
+
+// Stored value pointer of a slot (pointer value mode only)
+static inline void **hash_table_slot_value(const hash_table_t *table, size_t index) {
+    return table->_layout == HASH_TABLE_LAYOUT_INTERLEAVED ? &table->slots[index].value : &table->values[index];
+}
+
+// Value of a slot as handed to the user: the stored pointer, or a pointer into the value slab
+static inline void *hash_table_slot_value_data(const hash_table_t *table, size_t index) {
+    if (table->_value_size != 0) {
+        return table->value_data + index * table->_value_size;
+    }
+    return *hash_table_slot_value(table, index);
+}
+
+// Copy a slot's contents out
+// In fixed value size mode entry->value points at the slot's bytes in the value slab
+static inline void hash_table_slot_read(const hash_table_t *table, size_t index, hash_table_slot_t *entry) {
+    if (table->_layout == HASH_TABLE_LAYOUT_INTERLEAVED) {
+        *entry = table->slots[index];
+    } else {
+        entry->hash = table->hashes[index];
+        entry->key_size = table->key_sizes[index];
+        entry->key = table->keys[index];
+    }
+    entry->value = hash_table_slot_value_data(table, index);
+}
+
+// Store an entry into a slot and mark it full
+// In fixed value size mode the bytes at entry->value are copied into the value slab
+// (zero-filled if entry->value is NULL)
+static inline void hash_table_slot_write(hash_table_t *table, size_t index, const hash_table_slot_t *entry) {
+    if (table->_layout == HASH_TABLE_LAYOUT_INTERLEAVED) {
+        table->slots[index] = *entry;
+    } else {
+        table->hashes[index] = entry->hash;
+        table->keys[index] = entry->key;
+        table->key_sizes[index] = entry->key_size;
+    }
+    if (table->_value_size != 0) {
+        unsigned char *value_data = table->value_data + index * table->_value_size;
+        if (entry->value == NULL) {
+            memset(value_data, 0, table->_value_size);
+        } else if (entry->value != value_data) {
+            memmove(value_data, entry->value, table->_value_size);
+        }
+    } else {
+        *hash_table_slot_value(table, index) = entry->value;
+    }
+    hash_table_set_ctrl(table, index, hash_table_h2(entry->hash));
+}
+
+// Reset a slot's data (the control byte is managed by the caller)
+static inline void hash_table_slot_reset(hash_table_t *table, size_t index) {
+    if (table->_layout == HASH_TABLE_LAYOUT_INTERLEAVED) {
+        memset(&table->slots[index], 0, sizeof(hash_table_slot_t));
+    } else {
+        table->hashes[index] = 0;
+        memset(&table->keys[index], 0, sizeof(hash_table_key_t));
+        table->key_sizes[index] = 0;
+        if (table->values != NULL) {
+            table->values[index] = NULL;
+        }
+    }
+}
+
+static inline void hash_table_prefetch(const void *ptr) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(ptr);
+#else
+    (void)ptr;
+#endif
+}
+
+// Prefetch the slot data (not the control byte) of a slot
+static inline void hash_table_prefetch_slot(const hash_table_t *table, size_t index) {
+    if (table->_layout == HASH_TABLE_LAYOUT_INTERLEAVED) {
+        hash_table_prefetch(&table->slots[index]);
+    } else {
+        hash_table_prefetch(&table->keys[index]);
+        hash_table_prefetch(&table->key_sizes[index]);
+        if (table->values != NULL) {
+            hash_table_prefetch(&table->values[index]);
+        }
+    }
+    if (table->value_data != NULL) {
+        hash_table_prefetch(table->value_data + index * table->_value_size);
+    }
+}
+
+// Prefetch what a lookup reads from a candidate slot: the cached hash, key and key size to
+// compare, and the value pointer to return (all of it is one slot in the interleaved layout)
+static inline void hash_table_prefetch_lookup(const hash_table_t *table, size_t index) {
+    if (table->_layout == HASH_TABLE_LAYOUT_INTERLEAVED) {
+        hash_table_prefetch(&table->slots[index]);
+    } else {
+        hash_table_prefetch(&table->hashes[index]);
+        hash_table_prefetch(&table->keys[index]);
+        hash_table_prefetch(&table->key_sizes[index]);
+        if (table->values != NULL) {
+            hash_table_prefetch(&table->values[index]);
+        }
+    }
+}
+
+// ============================================================================
+// Key Arena
+// ============================================================================
+
+// Arena bytes taken by a key (rounded up so every key stays aligned)
+static inline size_t hash_table_key_arena_size(size_t key_size) {
+    const size_t alignment = _Alignof(max_align_t);
+    return (key_size + alignment - 1) & ~(alignment - 1);
+}
+
+static void hash_table_key_arena_free_chunks(hash_table_key_arena_t *arena, hash_table_key_arena_chunk_t *chunk) {
+    while (chunk != NULL) {
+        hash_table_key_arena_chunk_t *next = chunk->next;
+        hash_table_release(&arena->allocator, chunk);
+        chunk = next;
+    }
+}
+
+static hash_table_key_arena_chunk_t *hash_table_key_arena_new_chunk(hash_table_key_arena_t *arena, size_t capacity) {
+    hash_table_key_arena_chunk_t *chunk = hash_table_allocate(&arena->allocator, sizeof(hash_table_key_arena_chunk_t) + capacity);
+    if (chunk == NULL) return NULL;
+    chunk->next = NULL;
+    chunk->used = 0;
+    chunk->capacity = capacity;
+    return chunk;
+}
+
+// Bump-allocate size bytes (already rounded by hash_table_key_arena_size), or NULL
+static void *hash_table_key_arena_alloc(hash_table_key_arena_t *arena, size_t size) {
+    hash_table_key_arena_chunk_t *chunk = arena->chunks;
+    if (chunk == NULL || chunk->capacity - chunk->used < size) {
+        hash_table_key_arena_chunk_t *fresh =
+            hash_table_key_arena_new_chunk(arena, size > arena->chunk_size ? size : arena->chunk_size);
+        if (fresh == NULL) return NULL;
+        if (chunk != NULL && size > arena->chunk_size) {
+            // An oversized key gets a chunk of its own behind the current one,
+            // so the space left in the current chunk stays in use
+            fresh->next = chunk->next;
+            chunk->next = fresh;
+        } else {
+            fresh->next = chunk;
+            arena->chunks = fresh;
+        }
+        chunk = fresh;
+    }
+    void *ptr = chunk->data + chunk->used;
+    chunk->used += size;
+    arena->live += size;
+    return ptr;
+}
+
+// Drop every key at once, keeping the current chunk for reuse
+static void hash_table_key_arena_reset(hash_table_key_arena_t *arena) {
+    if (arena->chunks != NULL) {
+        hash_table_key_arena_free_chunks(arena, arena->chunks->next);
+        arena->chunks->next = NULL;
+        arena->chunks->used = 0;
+    }
+    arena->live = 0;
+    arena->dead = 0;
+}
+
+// Copy the live keys into fresh chunks and free the old ones, reclaiming removed keys
+// Must run with every occupied slot holding a live key (a removed key's slot already cleared)
+// Left for later if an incremental resize is in progress (keys live in two storages)
+// or if the new chunk cannot be allocated
+static void hash_table_key_arena_compact(hash_table_t *table) {
+    hash_table_key_arena_t *arena = table->_key_arena;
+    if (table->_old != NULL) return;
+
+    // One chunk that fits all live keys, so the copies below stay in it
+    size_t live = arena->live;
+    hash_table_key_arena_chunk_t *fresh =
+        hash_table_key_arena_new_chunk(arena, live > arena->chunk_size ? live : arena->chunk_size);
+    if (fresh == NULL) return;
+    hash_table_key_arena_chunk_t *old_chunks = arena->chunks;
+    arena->chunks = fresh;
+    arena->live = 0;
+
+    for (size_t i = hash_table_next_occupied(table, 0); i < table->capacity; i = hash_table_next_occupied(table, i + 1)) {
+        size_t key_size = hash_table_slot_key_size(table, i);
+        if (key_size > HASH_TABLE_INLINE_KEY_SIZE) {
+            hash_table_key_t *stored = hash_table_slot_key_ref(table, i);
+            void *copy = hash_table_key_arena_alloc(arena, hash_table_key_arena_size(key_size));
+            if (copy == NULL) {
+                // Keys not copied yet still point into the old chunks, so keep them
+                // behind the new ones; the originals of the copied keys become dead bytes
+                hash_table_key_arena_chunk_t *tail = arena->chunks;
+                while (tail->next != NULL) {
+                    tail = tail->next;
+                }
+                tail->next = old_chunks;
+                arena->dead += arena->live;
+                arena->live = live;
+                return;
             }
-            table->keys[i] = NULL;
-            table->values[i] = NULL;
+            memcpy(copy, stored->ptr, key_size);
+            stored->ptr = copy;
         }
     }
+    arena->dead = 0;
+    hash_table_key_arena_free_chunks(arena, old_chunks);
+}
+
+// Copy a key into a stored key, inline when it fits
+// Returns 0 on success, 1 on allocation failure
+static int hash_table_key_init(hash_table_t *table, hash_table_key_t *stored, const void *key, size_t key_size) {
+    if (key_size <= HASH_TABLE_INLINE_KEY_SIZE) {
+        memcpy(stored->bytes, key, key_size);
+        return 0;
+    }
+    if (table->_key_arena != NULL) {
+        stored->ptr = hash_table_key_arena_alloc(table->_key_arena, hash_table_key_arena_size(key_size));
+    } else {
+        stored->ptr = hash_table_allocate(&table->_allocator, key_size);
+    }
+    if (stored->ptr == NULL) return 1;
+    memcpy(stored->ptr, key, key_size);
+    return 0;
+}
+
+// Release a stored key's heap copy, if it has one
+// Arena copies are only accounted as dead, the arena reclaims them in bulk
+static inline void hash_table_key_release(hash_table_t *table, hash_table_key_t *stored, size_t key_size) {
+    if (key_size <= HASH_TABLE_INLINE_KEY_SIZE) return;
+    if (table->_key_arena != NULL) {
+        size_t size = hash_table_key_arena_size(key_size);
+        table->_key_arena->live -= size;
+        table->_key_arena->dead += size;
+    } else {
+        hash_table_release(&table->_allocator, stored->ptr);
+    }
+}
+
+// Release a value through the table's destructor (the table's allocator by default)
+// Inline values in fixed value size mode are only passed to the destructor, never freed
+static inline void hash_table_destroy_value(hash_table_t *table, void *value) {
+    if (table->_value_destructor != NULL) {
+        table->_value_destructor(value);
+    } else if (table->_value_size == 0) {
+        hash_table_release(&table->_allocator, value);
+    }
+}
+
+// Release every key and value in the table's storage and mark all slots empty
+// Only full slots are visited; without tombstones their control bytes are the only ones to
+// reset, so clearing a sparse table does not touch the whole control array
+static void hash_table_clear_slots(hash_table_t *table) {
+    int reset_all = table->_tombstones != 0;
+    for (size_t i = hash_table_next_occupied(table, 0); i < table->capacity; i = hash_table_next_occupied(table, i + 1)) {
+        hash_table_key_release(table, hash_table_slot_key_ref(table, i), hash_table_slot_key_size(table, i));
+        hash_table_destroy_value(table, hash_table_slot_value_data(table, i));
+        hash_table_slot_reset(table, i);
+        if (!reset_all) {
+            hash_table_set_ctrl(table, i, HASH_TABLE_CTRL_EMPTY);
+        }
+    }
+    if (reset_all) {
+        memset(table->ctrl, HASH_TABLE_CTRL_EMPTY, table->capacity + HASH_TABLE_GROUP_WIDTH - 1);
+        memset(table->occupied, 0, hash_table_occupied_words(table->capacity) * sizeof(uint64_t));
+    }
     table->size = 0;
+    table->_tombstones = 0;
+}
+
+// Release every entry, including those an incremental resize has not migrated yet
+static void hash_table_clear_entries(hash_table_t *table) {
+    if (table->_old != NULL) {
+        // Entries that were not migrated yet are dropped along with the old storage
+        hash_table_clear_slots(table->_old);
+        hash_table_free_slots(table->_old);
+        hash_table_release(&table->_allocator, table->_old);
+        table->_old = NULL;
+    }
+    hash_table_clear_slots(table);
+    if (table->_key_arena != NULL) {
+        hash_table_key_arena_reset(table->_key_arena);
+    }
+}
+
+void hash_table_clear(hash_table_t *table) {
+    if (table == NULL) return;
+    hash_table_clear_entries(table);
+
+    // A table that spiked should not keep walking (and holding) its peak capacity
+    if (table->_shrink_threshold > 0 && table->capacity > table->_min_capacity) {
+        hash_table_resize(table, table->_min_capacity);
+    }
 }
 
 size_t hash_table_size(hash_table_t *table) {
@@ -91,161 +896,783 @@ char hash_table_contains(hash_table_t *table, const void *key, size_t key_size)
     return hash_table_get(table, key, key_size) != NULL;
 }
 
+char hash_table_contains_prehashed(hash_table_t *table, const void *key, size_t key_size, size_t hash) {
+    return hash_table_get_prehashed(table, key, key_size, hash) != NULL;
+}
+
+size_t hash_table_hash(hash_table_t *table, const void *key, size_t key_size) {
+    if (table == NULL || key == NULL) return 0;
+    return hash_table_hash_key(table, key, key_size);
+}
+
 void *hash_table_get(hash_table_t *table, const void *key, size_t key_size) {
     if (table == NULL || key == NULL) return NULL;
+    return hash_table_get_prehashed(table, key, key_size, hash_table_hash_key(table, key, key_size));
+}
 
-    size_t index = hash_table_fnv_1a(key, key_size) % table->capacity;
-    size_t iterations = 0;
+void *hash_table_get_prehashed(hash_table_t *table, const void *key, size_t key_size, size_t hash) {
+    if (table == NULL || key == NULL) return NULL;
 
-    while (table->keys[index] != NULL && iterations < table->capacity) {
-        if (table->key_sizes[index] == key_size && 
-            memcmp(table->keys[index], key, key_size) == 0) {
-            return table->values[index];
-        }
+    if (table->_old != NULL) {
+        hash_table_migrate_step(table);
+    }
 
-        index = (index + 1) % table->capacity;
-        iterations++;
+    size_t index = hash_table_probe(table, key, key_size, hash, NULL);
+    if (index != HASH_TABLE_NOT_FOUND) {
+        return hash_table_slot_value_data(table, index);
     }
 
+    // Entries not migrated yet are still in the old storage
+    if (table->_old != NULL) {
+        index = hash_table_probe(table->_old, key, key_size, hash, NULL);
+        if (index != HASH_TABLE_NOT_FOUND) {
+            return hash_table_slot_value_data(table->_old, index);
+        }
+    }
     return NULL;
 }
 
+// Keys looked up together by hash_table_get_batch: enough independent misses to keep the
+// memory system busy, few enough that the prefetched lines are still cached when probed
+#define HASH_TABLE_GET_BATCH 32
+
+size_t hash_table_get_batch(hash_table_t *table, const void *const keys[], const size_t key_sizes[], size_t n, void *values[]) {
+    if (values == NULL) return 0;
+    if (table == NULL || keys == NULL || key_sizes == NULL) {
+        for (size_t i = 0; i < n; i++) {
+            values[i] = NULL;
+        }
+        return 0;
+    }
+
+    // Migrate as much as n calls to get would, but up front, so that no returned value pointer
+    // is moved by the lookups that follow it
+    for (size_t i = 0; i < n && table->_old != NULL; i++) {
+        hash_table_migrate_step(table);
+    }
+
+    size_t found = 0;
+    size_t hashes[HASH_TABLE_GET_BATCH];
+    for (size_t start = 0; start < n; start += HASH_TABLE_GET_BATCH) {
+        size_t count = n - start < HASH_TABLE_GET_BATCH ? n - start : HASH_TABLE_GET_BATCH;
+
+        // Each pass only touches memory the previous pass prefetched, so the misses of all
+        // keys in the batch overlap instead of forming one dependent chain per key
+        // Hash every key and start loading its home group of control bytes...
+        for (size_t i = 0; i < count; i++) {
+            if (keys[start + i] == NULL) continue;
+            hashes[i] = hash_table_hash_key(table, keys[start + i], key_sizes[start + i]);
+            hash_table_prefetch(table->ctrl + hash_table_home(table, hashes[i]));
+        }
+
+        // ...then the slot data of the first tag match, which is almost always the key...
+        for (size_t i = 0; i < count; i++) {
+            if (keys[start + i] == NULL) continue;
+            size_t home = hash_table_home(table, hashes[i]);
+            hash_table_mask_t match = hash_table_group_match(table->ctrl + home, hash_table_h2(hashes[i]));
+            if (match != 0) {
+                hash_table_prefetch_lookup(table, hash_table_wrap(table, home + hash_table_mask_first(match)));
+            }
+        }
+
+        // ...and probe
+        for (size_t i = 0; i < count; i++) {
+            const void *key = keys[start + i];
+            values[start + i] = NULL;
+            if (key == NULL) continue;
+
+            size_t index = hash_table_probe(table, key, key_sizes[start + i], hashes[i], NULL);
+            if (index != HASH_TABLE_NOT_FOUND) {
+                values[start + i] = hash_table_slot_value_data(table, index);
+            } else if (table->_old != NULL) {
+                index = hash_table_probe(table->_old, key, key_sizes[start + i], hashes[i], NULL);
+                if (index != HASH_TABLE_NOT_FOUND) {
+                    values[start + i] = hash_table_slot_value_data(table->_old, index);
+                }
+            }
+            found += values[start + i] != NULL;
+        }
+    }
+    return found;
+}
+
+// Compare two keys of the same size
+// Common small sizes compare whole words instead of calling memcmp
+static inline int hash_table_bytes_equal(const void *a, const void *b, size_t size) {
+    switch (size) {
+    case 4: {
+        uint32_t wa, wb;
+        memcpy(&wa, a, sizeof(wa));
+        memcpy(&wb, b, sizeof(wb));
+        return wa == wb;
+    }
+    case 8: {
+        uint64_t wa, wb;
+        memcpy(&wa, a, sizeof(wa));
+        memcpy(&wb, b, sizeof(wb));
+        return wa == wb;
+    }
+    case 16: {
+        uint64_t wa[2], wb[2];
+        memcpy(wa, a, sizeof(wa));
+        memcpy(wb, b, sizeof(wb));
+        return ((wa[0] ^ wb[0]) | (wa[1] ^ wb[1])) == 0;
+    }
+    default:
+        return memcmp(a, b, size) == 0;
+    }
+}
+
+// Does the key stored in a full slot equal the given key?
+// Uses the table's key equality function if it has one, else key size and bytes
+static inline int hash_table_slot_key_equals(const hash_table_t *table, size_t index, const void *key, size_t key_size) {
+    size_t stored_size = hash_table_slot_key_size(table, index);
+    if (table->_key_equal != NULL) {
+        return table->_key_equal(hash_table_slot_key(table, index), stored_size, key, key_size, table->_hash_context);
+    }
+    return stored_size == key_size && hash_table_bytes_equal(hash_table_slot_key(table, index), key, key_size);
+}
+
+// Look up a key by scanning its probe sequence one control group at a time
+// Only slots whose control byte matches the key's h2 tag are compared, and the
+// cached full hash is checked before the keys themselves
+// The scan stops at the first empty slot, since no chain continues past one
+// With Robin Hood probing it also stops after a group whose last slot holds an entry
+// closer to its home than the key would be there, since the key cannot lie beyond it
+//
+// Returns the slot holding the key, or HASH_TABLE_NOT_FOUND
+// If free_slot is not NULL, it receives the first empty or deleted slot seen
+// (HASH_TABLE_NOT_FOUND if there was none)
+static size_t hash_table_probe(const hash_table_t *table, const void *key, size_t key_size, size_t hash, size_t *free_slot) {
+    const uint8_t h2 = hash_table_h2(hash);
+    size_t index = hash_table_home(table, hash);
+    size_t available = HASH_TABLE_NOT_FOUND;
+
+    for (size_t probed = 0; probed < table->capacity; probed += HASH_TABLE_GROUP_WIDTH) {
+        const uint8_t *group = table->ctrl + index;
+        hash_table_mask_t empty = hash_table_group_match_empty(group);
+        hash_table_mask_t match = hash_table_group_match(group, h2);
+
+        // Slots after the first empty one are not part of this chain
+        if (empty != 0) {
+            match &= (empty & (0u - empty)) - 1;
+        }
+
+        while (match != 0) {
+            size_t slot = hash_table_wrap(table, index + hash_table_mask_first(match));
+            if (hash_table_slot_hash(table, slot) == hash &&
+                hash_table_slot_key_equals(table, slot, key, key_size)) {
+                if (free_slot != NULL) *free_slot = available;
+                return slot;
+            }
+            match &= match - 1;
+        }
+
+        if (available == HASH_TABLE_NOT_FOUND) {
+            hash_table_mask_t free_mask = hash_table_group_match_available(group);
+            if (free_mask != 0) {
+                available = hash_table_wrap(table, index + hash_table_mask_first(free_mask));
+            }
+        }
+
+        if (empty != 0) break;
+
+        if (table->_probing == HASH_TABLE_PROBING_ROBIN_HOOD) {
+            size_t last = hash_table_wrap(table, index + HASH_TABLE_GROUP_WIDTH - 1);
+            if (hash_table_distance(table, last, hash_table_slot_hash(table, last)) < probed + HASH_TABLE_GROUP_WIDTH - 1) {
+                break;
+            }
+        }
+        index = hash_table_wrap(table, index + HASH_TABLE_GROUP_WIDTH);
+    }
+
+    if (free_slot != NULL) *free_slot = available;
+    return HASH_TABLE_NOT_FOUND;
+}
+
+// Find the first empty or deleted slot in the probe sequence of a hash
+// The caller must guarantee the table is not full
+static size_t hash_table_find_free(const hash_table_t *table, size_t hash) {
+    size_t index = hash_table_home(table, hash);
+
+    for (;;) {
+        hash_table_mask_t free_mask = hash_table_group_match_available(table->ctrl + index);
+        if (free_mask != 0) {
+            return hash_table_wrap(table, index + hash_table_mask_first(free_mask));
+        }
+        index = hash_table_wrap(table, index + HASH_TABLE_GROUP_WIDTH);
+    }
+}
+
+// Robin Hood placement: walk from the home slot and take over the slot of the first
+// entry that is closer to its home than the carried entry, then carry that entry on
+// The carried entry is finally dropped into the first empty slot
+// Returns the slot the given entry landed in
+static size_t hash_table_place_robin_hood(hash_table_t *table, const hash_table_slot_t *entry) {
+    hash_table_slot_t carry = *entry;
+    size_t index = hash_table_home(table, carry.hash);
+    size_t distance = 0;
+    size_t placed = HASH_TABLE_NOT_FOUND;
+    size_t scratch = 0;
+
+    for (;;) {
+        if (!hash_table_ctrl_is_full(table->ctrl[index])) {
+            hash_table_slot_write(table, index, &carry);
+            return placed != HASH_TABLE_NOT_FOUND ? placed : index;
+        }
+
+        size_t resident_distance = hash_table_distance(table, index, hash_table_slot_hash(table, index));
+        if (resident_distance < distance) {
+            hash_table_slot_t resident;
+            hash_table_slot_read(table, index, &resident);
+
+            // Inline values are overwritten below, so park the resident's bytes in the
+            // scratch buffer the carried entry is not using
+            if (table->_value_size != 0) {
+                unsigned char *parked = table->_value_scratch + scratch * table->_value_size;
+                memcpy(parked, resident.value, table->_value_size);
+                resident.value = parked;
+                scratch ^= 1;
+            }
+
+            hash_table_slot_write(table, index, &carry);
+            if (placed == HASH_TABLE_NOT_FOUND) placed = index;
+            carry = resident;
+            distance = resident_distance;
+        }
+
+        index = hash_table_wrap(table, index + 1);
+        distance++;
+    }
+}
+
+// Put an entry whose key is not in the table into a slot, according to the probing policy
+// The caller must guarantee the table is not full
+// Returns the slot the entry landed in
+static size_t hash_table_place(hash_table_t *table, const hash_table_slot_t *entry) {
+    if (table->_probing == HASH_TABLE_PROBING_ROBIN_HOOD) {
+        return hash_table_place_robin_hood(table, entry);
+    }
+    size_t index = hash_table_find_free(table, entry->hash);
+    hash_table_slot_write(table, index, entry);
+    return index;
+}
+
+// Swap the contents of two full slots (control bytes follow the entries)
+static void hash_table_slot_swap(hash_table_t *table, size_t a, size_t b) {
+    hash_table_slot_t entry_a;
+    hash_table_slot_t entry_b;
+    hash_table_slot_read(table, a, &entry_a);
+    hash_table_slot_read(table, b, &entry_b);
+
+    // Inline values are overwritten by the first write, so park b's bytes first
+    if (table->_value_size != 0) {
+        memcpy(table->_value_scratch, entry_b.value, table->_value_size);
+        entry_b.value = table->_value_scratch;
+    }
+
+    hash_table_slot_write(table, b, &entry_a);
+    hash_table_slot_write(table, a, &entry_b);
+}
+
+// Rehash every entry into the current storage without allocating, dropping all tombstones
+// Linear probing only (Robin Hood tables never hold tombstones)
+//
+// Full slots are first marked deleted ("pending") and deleted slots become empty. Then each
+// pending entry goes to the first non-full slot of its probe sequence: it stays if that is
+// its own slot, moves if the target is empty, or swaps with a pending entry that is then
+// placed in turn. Every step settles one entry, so the whole pass is O(capacity)
+static void hash_table_rehash_in_place(hash_table_t *table) {
+    for (size_t i = 0; i < table->capacity; i++) {
+        table->ctrl[i] = hash_table_ctrl_is_full(table->ctrl[i]) ? HASH_TABLE_CTRL_DELETED : HASH_TABLE_CTRL_EMPTY;
+    }
+    hash_table_place_pending(table);
+}
+
+// Place every pending (deleted-marked) entry of the in-place rehash; no other tombstones may exist
+static void hash_table_place_pending(hash_table_t *table) {
+    for (size_t mirror = 0; mirror < HASH_TABLE_GROUP_WIDTH - 1; mirror++) {
+        table->ctrl[table->capacity + mirror] = table->ctrl[mirror % table->capacity];
+    }
+    table->_tombstones = table->size;
+
+    for (size_t i = 0; i < table->capacity; i++) {
+        while (table->ctrl[i] == HASH_TABLE_CTRL_DELETED) {
+            size_t hash = hash_table_slot_hash(table, i);
+            size_t target = hash_table_find_free(table, hash);
+
+            if (target == i) {
+                hash_table_set_ctrl(table, i, hash_table_h2(hash));
+            } else if (table->ctrl[target] == HASH_TABLE_CTRL_EMPTY) {
+                hash_table_slot_t entry;
+                hash_table_slot_read(table, i, &entry);
+                hash_table_slot_write(table, target, &entry);
+                hash_table_slot_reset(table, i);
+                hash_table_set_ctrl(table, i, HASH_TABLE_CTRL_EMPTY);
+            } else {
+                // Target holds another pending entry: swap, then place that one next
+                hash_table_slot_swap(table, i, target);
+                hash_table_set_ctrl(table, i, HASH_TABLE_CTRL_DELETED);
+            }
+        }
+    }
+}
+
+// Capacity to grow to when the load threshold is crossed, or 0 if it is too large to represent
+// Power-of-two tables round up so they keep mask-based indexing
+static size_t hash_table_grown_capacity(const hash_table_t *table) {
+    double grown = (double)table->capacity * table->_resize_factor;
+    if (grown > (double)HASH_TABLE_MAX_CAPACITY) return 0;
+    size_t new_capacity = (size_t)grown;
+    if (new_capacity <= table->capacity) {
+        new_capacity = table->capacity + 1;
+    }
+    if (new_capacity > HASH_TABLE_MAX_CAPACITY) return 0;
+    if (hash_table_is_power_of_two(table->capacity)) {
+        size_t rounded = table->capacity;
+        while (rounded < new_capacity) {
+            rounded <<= 1;
+        }
+        new_capacity = rounded;
+    }
+    return new_capacity;
+}
+
+// Capacity needed to hold a number of entries without crossing the resize threshold,
+// or 0 if it is too large to represent
+// Power-of-two tables round up so they keep mask-based indexing
+static size_t hash_table_capacity_for(const hash_table_t *table, size_t entries) {
+    double needed = (double)entries / table->_resize_threshold;
+    if (needed >= (double)HASH_TABLE_MAX_CAPACITY) return 0;
+    size_t capacity = (size_t)needed;
+    if (capacity < 1) capacity = 1;
+    // Same check as the insert path, so the last of the entries does not trigger a resize
+    while ((float)entries / capacity > table->_resize_threshold) {
+        capacity++;
+    }
+    if (hash_table_is_power_of_two(table->capacity)) {
+        size_t rounded = 1;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        capacity = rounded;
+    }
+    return capacity;
+}
+
+// Halve the capacity after a remove if the load dropped below the shrink threshold
+// Only halves if the load afterwards is at most half the resize threshold, so the table
+// has to take that many inserts again before it grows back (no thrashing at the boundary)
+static void hash_table_maybe_shrink(hash_table_t *table) {
+    if (table->_shrink_threshold <= 0 || table->_old != NULL) return;
+    if ((float)table->size / table->capacity >= table->_shrink_threshold) return;
+
+    size_t new_capacity = table->capacity / 2;
+    if (new_capacity < table->_min_capacity) return;
+    if ((float)table->size / new_capacity > table->_resize_threshold / 2) return;
+
+    // A failed shrink leaves the table as it is, which is still correct
+    if (table->_migration_batch != 0) {
+        hash_table_start_migration(table, new_capacity);
+    } else {
+        hash_table_resize(table, new_capacity);
+    }
+}
+
+// Move all entries into storage of a new capacity (larger or smaller, as long as they fit)
 static int hash_table_resize(hash_table_t *table, size_t new_capacity) {
-    if (table == NULL || new_capacity <= table->capacity) return 1;
+    if (table == NULL) return 1;
 
-    // Save old arrays
-    void **old_keys = table->keys;
-    size_t *old_key_sizes = table->key_sizes;
-    void **old_values = table->values;
-    size_t old_capacity = table->capacity;
+    hash_table_finish_migration(table);
+    if (new_capacity == 0 || new_capacity < table->size) return 1;
 
-    // Allocate new arrays
-    table->keys = calloc(new_capacity, sizeof(void *));
-    table->key_sizes = calloc(new_capacity, sizeof(size_t));
-    table->values = calloc(new_capacity, sizeof(void *));
-    
-    if (table->keys == NULL || table->key_sizes == NULL || table->values == NULL) {
+    // Mapped storage grows in place when it can, everything else is rebuilt
+    if ((new_capacity <= table->capacity || hash_table_grow_mapped(table, new_capacity) != 0) &&
+        hash_table_rebuild(table, new_capacity) != 0) {
         fprintf(stderr, "Error: Failed to allocate memory for resized hash table.\n");
-        // Restore old arrays on failure
-        free(table->keys);
-        free(table->key_sizes);
-        free(table->values);
-        table->keys = old_keys;
-        table->key_sizes = old_key_sizes;
-        table->values = old_values;
         return 1;
     }
 
-    // Update capacity and reset size
-    table->capacity = new_capacity;
-    table->size = 0;
+    // Rebuilt storage has fresh clusters, so go back to the configured reseed trigger
+    table->_probe_limit = table->_max_probe_length;
+    return 0;
+}
 
-    // Rehash all existing entries into the new arrays
-    for (size_t i = 0; i < old_capacity; i++) {
-        if (old_keys[i] != NULL) {
-            // Find new position using hash function and linear probing
-            size_t index = hash_table_fnv_1a(old_keys[i], old_key_sizes[i]) % table->capacity;
-            size_t iterations = 0;
-            
-            while (table->keys[index] != NULL && iterations < table->capacity) {
-                index = (index + 1) % table->capacity;
-                iterations++;
-            }
-            
-            // Move key, key_size, and value to new arrays
-            table->keys[index] = old_keys[i];
-            table->key_sizes[index] = old_key_sizes[i];
-            table->values[index] = old_values[i];
-            table->size++;
-        }
+// Move every entry into freshly allocated storage of the given capacity
+// Returns 0 on success, 1 on allocation failure (the table is unchanged)
+static int hash_table_rebuild(hash_table_t *table, size_t new_capacity) {
+    // Keep the old storage in a copy of the table so the slot accessors can read it
+    hash_table_t old = *table;
+
+    if (hash_table_alloc_slots(table, new_capacity) != 0) {
+        // Restore old storage on failure
+        *table = old;
+        return 1;
+    }
+
+    // Rehash all existing entries into the new storage
+    for (size_t i = hash_table_next_occupied(&old, 0); i < old.capacity; i = hash_table_next_occupied(&old, i + 1)) {
+        // Keys and values are moved, not copied, and the cached hash is reused
+        hash_table_slot_t entry;
+        hash_table_slot_read(&old, i, &entry);
+        hash_table_place(table, &entry);
     }
 
-    // Free old arrays (keys/values have been moved, not freed)
-    free(old_keys);
-    free(old_key_sizes);
-    free(old_values);
+    // Free old storage (keys/values have been moved, not freed)
+    hash_table_free_slots(&old);
     
     return 0;
 }
 
-int hash_table_insert(hash_table_t *table, const void *key, size_t key_size, void *value) {
-    if (table == NULL || key == NULL) return 1;
+// Recompute the cached hash and control byte of every full slot (entries stay where they are)
+static void hash_table_recompute_hashes(hash_table_t *table) {
+    for (size_t i = hash_table_next_occupied(table, 0); i < table->capacity; i = hash_table_next_occupied(table, i + 1)) {
+        hash_table_slot_t entry;
+        hash_table_slot_read(table, i, &entry);
+        entry.hash = hash_table_hash_key(table, hash_table_key_data(&entry.key, entry.key_size), entry.key_size);
+        hash_table_slot_write(table, i, &entry);
+    }
+}
 
-    if ((float)(table->size + 1) / table->capacity > table->_resize_threshold) {
-        if (hash_table_resize(table, (size_t)(table->capacity * table->_resize_factor)) != 0) {
-            fprintf(stderr, "Error: Failed to resize hash table during insert.\n");
-            return 1;
+// Switch to a new random seed and rehash every entry at the same capacity
+// Linear tables rehash in place; Robin Hood tables are rebuilt to restore their ordering
+// Returns 0 on success, 1 on allocation failure (the table keeps its old seed)
+static int hash_table_reseed(hash_table_t *table) {
+    // Entries still in the old storage are hashed with the current seed
+    hash_table_finish_migration(table);
+
+    uint64_t old_seed = table->_seed;
+    table->_seed = hash_table_random_seed();
+    hash_table_recompute_hashes(table);
+
+    if (table->_probing == HASH_TABLE_PROBING_LINEAR) {
+        hash_table_rehash_in_place(table);
+    } else if (hash_table_rebuild(table, table->capacity) != 0) {
+        table->_seed = old_seed;
+        hash_table_recompute_hashes(table);
+        return 1;
+    }
+
+    // Keys that still collide after a reseed are not seed dependent (or the load is high),
+    // so back off instead of rehashing on every insert
+    table->_probe_limit *= 2;
+    return 0;
+}
+
+// ============================================================================
+// Incremental Resize
+// ============================================================================
+// While an incremental resize is in progress, table->_old holds the previous storage.
+// Every key lives in exactly one of the two storages and table->size counts both.
+// Migrated old slots are marked deleted, so probe chains through them stay intact for
+// lookups of entries that have not moved yet. The old copy always probes linearly, which
+// finds every entry of a Robin Hood layout too, without relying on its early exit.
+
+// Start resizing to new_capacity, leaving the entries in the old storage
+// Returns 0 on success, 1 on allocation failure (the table is unchanged)
+static int hash_table_start_migration(hash_table_t *table, size_t new_capacity) {
+    if (new_capacity == 0) return 1;
+    hash_table_finish_migration(table);
+
+    hash_table_t *old = hash_table_allocate(&table->_allocator, sizeof(hash_table_t));
+    if (old == NULL) return 1;
+    *old = *table;
+
+    if (hash_table_alloc_slots(table, new_capacity) != 0) {
+        fprintf(stderr, "Error: Failed to allocate memory for resized hash table.\n");
+        *table = *old;
+        hash_table_release(&table->_allocator, old);
+        return 1;
+    }
+    old->_probing = HASH_TABLE_PROBING_LINEAR;
+    table->_old = old;
+    table->_migrate_index = 0;
+    table->_probe_limit = table->_max_probe_length;
+    return 0;
+}
+
+// Move the entry in one full old slot into the new storage
+static void hash_table_migrate_slot(hash_table_t *table, size_t index) {
+    hash_table_t *old = table->_old;
+    hash_table_slot_t entry;
+    hash_table_slot_read(old, index, &entry);
+    hash_table_place(table, &entry);
+    hash_table_slot_reset(old, index);
+    hash_table_set_ctrl(old, index, HASH_TABLE_CTRL_DELETED);
+    old->size--;
+}
+
+// Free the old storage once its last entry has moved
+static void hash_table_end_migration_if_done(hash_table_t *table) {
+    if (table->_old->size == 0) {
+        hash_table_free_slots(table->_old);
+        hash_table_release(&table->_allocator, table->_old);
+        table->_old = NULL;
+    }
+}
+
+// Migrate the next batch of old slots
+static void hash_table_migrate_step(hash_table_t *table) {
+    hash_table_t *old = table->_old;
+    size_t end = table->_migrate_index + table->_migration_batch;
+    if (end > old->capacity) end = old->capacity;
+
+    table->_migrate_index = hash_table_next_occupied(old, table->_migrate_index);
+    while (table->_migrate_index < end && old->size > 0) {
+        hash_table_migrate_slot(table, table->_migrate_index);
+        table->_migrate_index = hash_table_next_occupied(old, table->_migrate_index + 1);
+    }
+    hash_table_end_migration_if_done(table);
+}
+
+// Move a key out of the old storage ahead of the scan, if it is still there
+// Inserts and removes call this so they only ever have to deal with the new storage
+static void hash_table_migrate_key(hash_table_t *table, const void *key, size_t key_size, size_t hash) {
+    size_t index = hash_table_probe(table->_old, key, key_size, hash, NULL);
+    if (index != HASH_TABLE_NOT_FOUND) {
+        hash_table_migrate_slot(table, index);
+        hash_table_end_migration_if_done(table);
+    }
+}
+
+// Migrate everything that is left (no-op when no incremental resize is in progress)
+static void hash_table_finish_migration(hash_table_t *table) {
+    if (table->_old == NULL) return;
+    hash_table_t *old = table->_old;
+    for (size_t i = hash_table_next_occupied(old, table->_migrate_index); i < old->capacity; i = hash_table_next_occupied(old, i + 1)) {
+        hash_table_migrate_slot(table, i);
+    }
+    table->_old->size = 0;
+    hash_table_end_migration_if_done(table);
+}
+
+// Find the slot holding a key, or claim a free slot for it if the key is new
+// A claimed slot gets the key copy, hash and control byte and counts towards size;
+// its value is empty (NULL, or zero-filled in fixed value size mode) for the caller to set
+//
+// Returns 0 on success, with *index set and *found telling whether the key already existed
+// Returns 1 on failure, leaving the table unchanged
+static int hash_table_find_or_claim(hash_table_t *table, const void *key, size_t key_size, size_t hash, size_t *index, int *found) {
+    if (table->_old != NULL) {
+        hash_table_migrate_step(table);
+        if (table->_old != NULL) {
+            hash_table_migrate_key(table, key, key_size, hash);
         }
     }
 
-    size_t index = hash_table_fnv_1a(key, key_size) % table->capacity;
-    size_t iterations = 0;
+    size_t free_slot;
+    size_t existing = hash_table_probe(table, key, key_size, hash, &free_slot);
 
-    while (table->keys[index] != NULL && iterations < table->capacity) {
+    if (existing != HASH_TABLE_NOT_FOUND) {
+        *index = existing;
+        *found = 1;
+        return 0;
+    }
 
-        // If the key already exists, update its value
-        if (table->key_sizes[index] == key_size && 
-            memcmp(table->keys[index], key, key_size) == 0) {
-            if (table->_value_destructor != NULL) {
-                table->_value_destructor(table->values[index]);
-            } else {
-                free(table->values[index]);
+    // Tombstones lengthen probe chains like entries do, so they count towards the load
+    // If the entries alone fit, cleaning up the tombstones in place is enough
+    if ((float)(table->size + table->_tombstones + 1) / table->capacity > table->_resize_threshold) {
+        if (table->_tombstones > 0 &&
+            (float)(table->size + 1) / table->capacity <= table->_resize_threshold) {
+            hash_table_rehash_in_place(table);
+        } else if (table->_migration_batch != 0) {
+            if (hash_table_start_migration(table, hash_table_grown_capacity(table)) != 0) {
+                fprintf(stderr, "Error: Failed to resize hash table during insert.\n");
+                return 1;
             }
-            table->values[index] = value;
-            return 0;
+        } else if (hash_table_resize(table, hash_table_grown_capacity(table)) != 0) {
+            fprintf(stderr, "Error: Failed to resize hash table during insert.\n");
+            return 1;
         }
+        free_slot = HASH_TABLE_NOT_FOUND;
+    }
 
-        index = (index + 1) % table->capacity;
-        iterations++;
+    if (table->size >= table->capacity) {
+        fprintf(stderr, "Error: No free slot available in hash table.\n");
+        return 1;
     }
 
-    // Must have landed on a NULL slot, so insert new key-value pair
-    void *key_copy = malloc(key_size);
-    if (key_copy == NULL) {
+    hash_table_slot_t entry;
+    entry.hash = hash;
+    entry.key_size = key_size;
+    entry.value = NULL;
+    if (hash_table_key_init(table, &entry.key, key, key_size) != 0) {
         fprintf(stderr, "Error: Failed to allocate memory for key.\n");
         return 1;
     }
-    memcpy(key_copy, key, key_size);
-    
-    table->keys[index] = key_copy;
-    table->key_sizes[index] = key_size;
-    table->values[index] = value;
+
+    // Linear probing reuses the free slot the probe already found
+    if (table->_probing == HASH_TABLE_PROBING_LINEAR && free_slot != HASH_TABLE_NOT_FOUND) {
+        hash_table_slot_write(table, free_slot, &entry);
+        *index = free_slot;
+    } else {
+        *index = hash_table_place(table, &entry);
+    }
     table->size++;
+    *found = 0;
+
+    // An entry this far from home means a pathological cluster, most likely from keys
+    // chosen to collide under the current seed; a new seed scatters them again
+    if (table->_probe_limit != 0 && hash_table_distance(table, *index, hash) > table->_probe_limit) {
+        if (hash_table_reseed(table) == 0) {
+            *index = hash_table_probe(table, key, key_size, hash_table_hash_key(table, key, key_size), NULL);
+        }
+    }
+    return 0;
+}
+
+// Set the value of a slot, destroying the previous value if the key already existed
+// In fixed value size mode the bytes at value are copied into the value slab
+static void hash_table_set_value(hash_table_t *table, size_t index, int found, const void *value) {
+    if (found) {
+        hash_table_destroy_value(table, hash_table_slot_value_data(table, index));
+    }
+    if (table->_value_size != 0) {
+        void *value_data = hash_table_slot_value_data(table, index);
+        if (value != NULL) {
+            memcpy(value_data, value, table->_value_size);
+        } else {
+            memset(value_data, 0, table->_value_size);
+        }
+    } else {
+        *hash_table_slot_value(table, index) = (void *)value;
+    }
+}
+
+int hash_table_insert_prehashed(hash_table_t *table, const void *key, size_t key_size, size_t hash, void *value) {
+    if (table == NULL || key == NULL) return 1;
+
+    size_t index;
+    int found;
+    if (hash_table_find_or_claim(table, key, key_size, hash, &index, &found) != 0) {
+        return 1;
+    }
+
+    // If the key already exists, its old value is destroyed and replaced
+    hash_table_set_value(table, index, found, value);
+
+    // Inline values keep a copy, so the table is done with the passed buffer
+    if (table->_value_size != 0) {
+        hash_table_release(&table->_allocator, value);
+    }
     return 0;
 }
 
+int hash_table_insert(hash_table_t *table, const void *key, size_t key_size, void *value) {
+    if (table == NULL || key == NULL) return 1;
+    return hash_table_insert_prehashed(table, key, key_size, hash_table_hash_key(table, key, key_size), value);
+}
+
+void *hash_table_emplace(hash_table_t *table, const void *key, size_t key_size) {
+    if (table == NULL || key == NULL || table->_value_size == 0) return NULL;
+
+    size_t index;
+    int found;
+    if (hash_table_find_or_claim(table, key, key_size, hash_table_hash_key(table, key, key_size), &index, &found) != 0) {
+        return NULL;
+    }
+    return hash_table_slot_value_data(table, index);
+}
+
+// Fill the hole left by a removed entry by shifting later entries of its cluster back
+// An entry moves into the hole when the hole lies on its probe path (its distance from
+// home is at least its distance from the hole); the slot it leaves becomes the new hole
+// The scan ends at an empty slot, or with Robin Hood probing at an entry in its home slot
+// In a full table there is no empty slot, so it also ends when it wraps back to the hole
+// The last hole becomes empty, so no deleted marker is left behind
+static void hash_table_shift_back(hash_table_t *table, size_t hole) {
+    size_t next = hash_table_wrap(table, hole + 1);
+    size_t gap = 1;
+
+    while (next != hole && hash_table_ctrl_is_full(table->ctrl[next])) {
+        size_t distance = hash_table_distance(table, next, hash_table_slot_hash(table, next));
+        if (distance >= gap) {
+            hash_table_slot_t entry;
+            hash_table_slot_read(table, next, &entry);
+            hash_table_slot_write(table, hole, &entry);
+            hole = next;
+            gap = 0;
+        } else if (table->_probing == HASH_TABLE_PROBING_ROBIN_HOOD) {
+            // Robin Hood clusters are ordered by home slot, nothing further can move
+            break;
+        }
+        next = hash_table_wrap(table, next + 1);
+        gap++;
+    }
+
+    hash_table_slot_reset(table, hole);
+    hash_table_set_ctrl(table, hole, HASH_TABLE_CTRL_EMPTY);
+}
+
 void hash_table_remove(hash_table_t *table, const void *key, size_t key_size) {
     if (table == NULL || key == NULL) return;
+    hash_table_remove_prehashed(table, key, key_size, hash_table_hash_key(table, key, key_size));
+}
 
-    size_t index = hash_table_fnv_1a(key, key_size) % table->capacity;
-    size_t iterations = 0;
+void hash_table_remove_prehashed(hash_table_t *table, const void *key, size_t key_size, size_t hash) {
+    if (table == NULL || key == NULL) return;
 
-    while (table->keys[index] != NULL && iterations < table->capacity) {
-        if (table->key_sizes[index] == key_size &&
-            memcmp(table->keys[index], key, key_size) == 0) {
-            free(table->keys[index]);
-            if (table->_value_destructor != NULL) {
-                table->_value_destructor(table->values[index]);
-            } else {
-                free(table->values[index]);
-            }
-            table->keys[index] = NULL;
-            table->key_sizes[index] = 0;
-            table->values[index] = NULL;
-            table->size--;
-            return;
+    if (table->_old != NULL) {
+        hash_table_migrate_step(table);
+        if (table->_old != NULL) {
+            hash_table_migrate_key(table, key, key_size, hash);
         }
+    }
+
+    size_t index = hash_table_probe(table, key, key_size, hash, NULL);
+    if (index == HASH_TABLE_NOT_FOUND) return;
+
+    hash_table_key_release(table, hash_table_slot_key_ref(table, index), hash_table_slot_key_size(table, index));
+    hash_table_destroy_value(table, hash_table_slot_value_data(table, index));
+    table->size--;
 
-        index = (index + 1) % table->capacity;
-        iterations++;
+    if (table->_deletion == HASH_TABLE_DELETION_TOMBSTONE && table->_probing == HASH_TABLE_PROBING_LINEAR) {
+        // Mark the slot deleted so chains running through it stay intact
+        // If the next slot is empty no chain continues past this one, so it can become empty
+        hash_table_slot_reset(table, index);
+        size_t next = hash_table_wrap(table, index + 1);
+        hash_table_set_ctrl(table, index,
+            table->ctrl[next] == HASH_TABLE_CTRL_EMPTY ? HASH_TABLE_CTRL_EMPTY : HASH_TABLE_CTRL_DELETED);
+
+        if ((float)table->_tombstones > table->capacity * table->_tombstone_threshold) {
+            hash_table_rehash_in_place(table);
+        }
+    } else {
+        // Close the gap so probe chains stay short and free of deleted markers
+        hash_table_shift_back(table, index);
+    }
+
+    // Compact once the slot is cleared, so the removed key is not copied along
+    hash_table_key_arena_t *arena = table->_key_arena;
+    if (arena != NULL && arena->dead > arena->live && arena->dead >= arena->chunk_size) {
+        hash_table_key_arena_compact(table);
     }
+
+    hash_table_maybe_shrink(table);
 }
 
-int hash_table_insert_copy(hash_table_t *table, const void *key, size_t key_size, const void *value, size_t value_size) {
+int hash_table_insert_copy_prehashed(hash_table_t *table, const void *key, size_t key_size, size_t hash,
+                                     const void *value, size_t value_size) {
     if (table == NULL || key == NULL || value == NULL) return 1;
 
+    // Fixed value size mode copies straight into the value slab
+    if (table->_value_size != 0) {
+        if (value_size != table->_value_size) {
+            fprintf(stderr, "Error: Value size does not match the table's fixed value size.\n");
+            return 1;
+        }
+
+        size_t index;
+        int found;
+        if (hash_table_find_or_claim(table, key, key_size, hash, &index, &found) != 0) {
+            return 1;
+        }
+        hash_table_set_value(table, index, found, value);
+        return 0;
+    }
+
     // Allocate memory and copy the value
-    void *value_copy = malloc(value_size);
+    void *value_copy = hash_table_allocate(&table->_allocator, value_size);
     if (value_copy == NULL) {
         fprintf(stderr, "Error: Failed to allocate memory for value copy.\n");
         return 1;
@@ -253,28 +1680,217 @@ int hash_table_insert_copy(hash_table_t *table, const void *key, size_t key_size
     memcpy(value_copy, value, value_size);
 
     // Use regular insert with the copied value
-    int result = hash_table_insert(table, key, key_size, value_copy);
+    int result = hash_table_insert_prehashed(table, key, key_size, hash, value_copy);
     
     // If insert failed, free the copy we just made
     if (result != 0) {
-        free(value_copy);
+        hash_table_release(&table->_allocator, value_copy);
     }
     
     return result;
 }
 
-// FNV-1a hash function for arbitrary byte arrays
-static size_t hash_table_fnv_1a(const void *key, size_t key_size) {
-    const size_t fnv_prime = 0x1000193;
-    size_t hash = 0x811C9DC5;
-    const unsigned char *bytes = (const unsigned char *)key;
+int hash_table_insert_copy(hash_table_t *table, const void *key, size_t key_size, const void *value, size_t value_size) {
+    if (table == NULL || key == NULL || value == NULL) return 1;
+    return hash_table_insert_copy_prehashed(table, key, key_size, hash_table_hash_key(table, key, key_size), value, value_size);
+}
+
+// Keys inserted together by hash_table_insert_batch (see HASH_TABLE_GET_BATCH)
+#define HASH_TABLE_INSERT_BATCH 32
+
+int hash_table_insert_batch(hash_table_t *table, const void *const keys[], const size_t key_sizes[],
+                            const void *const values[], size_t value_size, size_t n, int results[]) {
+    if (table == NULL || keys == NULL || key_sizes == NULL || values == NULL) {
+        for (size_t i = 0; results != NULL && i < n; i++) {
+            results[i] = 1;
+        }
+        return 1;
+    }
+
+    // One resize for the whole batch instead of one per threshold crossed; if it fails the
+    // inserts below still grow the table (or fail) one at a time
+    if (n <= SIZE_MAX - table->size) {
+        hash_table_reserve(table, table->size + n);
+    }
+
+    int failed = 0;
+    size_t hashes[HASH_TABLE_INSERT_BATCH];
+    for (size_t start = 0; start < n; start += HASH_TABLE_INSERT_BATCH) {
+        size_t count = n - start < HASH_TABLE_INSERT_BATCH ? n - start : HASH_TABLE_INSERT_BATCH;
+        uint64_t seed = table->_seed;
+
+        // Same staging as hash_table_get_batch: hash and prefetch the home groups...
+        for (size_t i = 0; i < count; i++) {
+            if (keys[start + i] == NULL) continue;
+            hashes[i] = hash_table_hash_key(table, keys[start + i], key_sizes[start + i]);
+            hash_table_prefetch(table->ctrl + hash_table_home(table, hashes[i]));
+        }
+
+        // ...then the slot an existing key would be in, or the one a new key will take...
+        for (size_t i = 0; i < count; i++) {
+            if (keys[start + i] == NULL) continue;
+            size_t home = hash_table_home(table, hashes[i]);
+            hash_table_mask_t match = hash_table_group_match(table->ctrl + home, hash_table_h2(hashes[i]));
+            if (match == 0) {
+                match = hash_table_group_match_available(table->ctrl + home);
+            }
+            if (match != 0) {
+                hash_table_prefetch_slot(table, hash_table_wrap(table, home + hash_table_mask_first(match)));
+            }
+        }
+
+        // ...and insert
+        for (size_t i = 0; i < count; i++) {
+            const void *key = keys[start + i];
+            int result = 1;
+            if (key != NULL) {
+                // A long probe earlier in the batch may have reseeded the table
+                if (table->_seed != seed) {
+                    hashes[i] = hash_table_hash_key(table, key, key_sizes[start + i]);
+                }
+                result = hash_table_insert_copy_prehashed(table, key, key_sizes[start + i], hashes[i],
+                                                          values[start + i], value_size);
+            }
+            if (results != NULL) {
+                results[start + i] = result;
+            }
+            failed |= result;
+        }
+    }
+    return failed;
+}
+
+int hash_table_reserve(hash_table_t *table, size_t n) {
+    if (table == NULL) return 1;
+
+    size_t capacity = hash_table_capacity_for(table, n);
+    if (capacity == 0) return 1;
+    if (capacity <= table->capacity) return 0;
+    return hash_table_resize(table, capacity);
+}
+
+int hash_table_shrink_to_fit(hash_table_t *table) {
+    if (table == NULL) return 1;
+
+    size_t capacity = hash_table_capacity_for(table, table->size);
+    if (capacity >= table->capacity) return 0;
+    return hash_table_resize(table, capacity);
+}
+
+// ============================================================================
+// Iteration
+// ============================================================================
+
+void hash_table_iter_init(hash_table_iter_t *iter, hash_table_t *table) {
+    if (iter == NULL) return;
+    iter->key = NULL;
+    iter->key_size = 0;
+    iter->value = NULL;
+    iter->_table = table;
+    iter->_storage = table;
+    iter->_word = 0;
+    iter->_pending = table != NULL ? table->occupied[0] : 0;
+}
+
+int hash_table_iter_next(hash_table_iter_t *iter) {
+    if (iter == NULL) return 0;
+
+    while (iter->_storage != NULL) {
+        hash_table_t *storage = iter->_storage;
+        size_t words = hash_table_occupied_words(storage->capacity);
+        while (iter->_pending == 0 && ++iter->_word < words) {
+            iter->_pending = storage->occupied[iter->_word];
+        }
+
+        if (iter->_pending != 0) {
+            size_t index = iter->_word * 64 + hash_table_ctz64(iter->_pending);
+            iter->_pending &= iter->_pending - 1;
+            // The next full slot of the word is known, so fetch its data while this one is used
+            if (iter->_pending != 0) {
+                hash_table_prefetch_slot(storage, iter->_word * 64 + hash_table_ctz64(iter->_pending));
+            }
+            iter->key = hash_table_slot_key(storage, index);
+            iter->key_size = hash_table_slot_key_size(storage, index);
+            iter->value = hash_table_slot_value_data(storage, index);
+            return 1;
+        }
 
-    for (size_t i = 0; i < key_size; i++) {
-        hash ^= bytes[i];
-        hash *= fnv_prime;
+        // Then the entries an incremental resize has not migrated yet
+        iter->_storage = storage == iter->_table ? iter->_table->_old : NULL;
+        iter->_word = 0;
+        iter->_pending = iter->_storage != NULL ? iter->_storage->occupied[0] : 0;
     }
+    return 0;
+}
+
+// Visit the entries of one storage whose home is in the buckets [first, last]
+// With by_position, only those whose hash position (hash times the Fibonacci multiplier, whose
+// top bits are the home slot of a power-of-two storage) is in [start, end) are visited, end 0
+// meaning the top of the hash space
+// Entries live between their home and the next empty slot, so the walk starts at the first
+// bucket and goes on past the last one until it reaches an empty slot
+static void hash_table_scan_storage(hash_table_t *storage, size_t first, size_t last, int by_position,
+                                    size_t start, size_t end, scan_callback_t callback, void *context) {
+    size_t buckets = last - first + 1;
+    size_t index = first;
+    for (size_t walked = 0; walked < storage->capacity; walked++, index = hash_table_wrap(storage, index + 1)) {
+        if (walked >= buckets && storage->ctrl[index] == HASH_TABLE_CTRL_EMPTY) break;
+        if (!hash_table_ctrl_is_full(storage->ctrl[index])) continue;
+
+        size_t hash = hash_table_slot_hash(storage, index);
+        int in_range;
+        if (by_position) {
+            size_t position = hash * HASH_TABLE_FIBONACCI_MULTIPLIER;
+            in_range = position >= start && (end == 0 || position < end);
+        } else {
+            size_t home = hash_table_home(storage, hash);
+            in_range = home >= first && home <= last;
+        }
+        if (in_range) {
+            callback(hash_table_slot_key(storage, index), hash_table_slot_key_size(storage, index),
+                     hash_table_slot_value_data(storage, index), context);
+        }
+    }
+}
 
-    return hash;
+size_t hash_table_scan(hash_table_t *table, size_t cursor, size_t count, scan_callback_t callback, void *context) {
+    if (table == NULL || callback == NULL) return 0;
+    if (count == 0) count = 1;
+
+    if (table->_hash_shift == 0) {
+        // Modulo indexing has no hash order that survives a resize: the cursor is a bucket,
+        // and the old storage of an incremental resize is covered proportionally
+        if (cursor >= table->capacity) return 0;
+        size_t next = count < table->capacity - cursor ? cursor + count : table->capacity;
+        hash_table_scan_storage(table, cursor, next - 1, 0, 0, 0, callback, context);
+        if (table->_old != NULL) {
+            hash_table_t *old = table->_old;
+            size_t old_first = (size_t)((double)cursor * old->capacity / table->capacity);
+            size_t old_next = (size_t)((double)next * old->capacity / table->capacity);
+            if (next == table->capacity) old_next = old->capacity;
+            if (old_next > old_first) {
+                hash_table_scan_storage(old, old_first, old_next - 1, 0, 0, 0, callback, context);
+            }
+        }
+        return next < table->capacity ? next : 0;
+    }
+
+    // The cursor is a hash position: everything below it has been visited. A bucket of the
+    // current capacity spans 2^_hash_shift positions, and since the home slot is the top bits
+    // of the position, any capacity maps a range of positions to a range of buckets
+    size_t remaining = (SIZE_MAX - cursor) >> table->_hash_shift;
+    size_t end = count <= remaining ? cursor + (count << table->_hash_shift) : 0;
+    for (hash_table_t *storage = table; storage != NULL; storage = storage == table ? table->_old : NULL) {
+        if (storage->_hash_shift != 0) {
+            size_t first = (cursor >> storage->_hash_shift) & storage->_mask;
+            size_t last = ((end - 1) >> storage->_hash_shift) & storage->_mask;
+            hash_table_scan_storage(storage, first, last, 1, cursor, end, callback, context);
+        } else {
+            // Old modulo storage of a table that grew to a power of two: walk all of it
+            hash_table_scan_storage(storage, 0, storage->capacity - 1, 1, cursor, end, callback, context);
+        }
+    }
+    return end;
 }
 
 // ============================================================================
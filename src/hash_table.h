@@ -1,23 +1,142 @@
 #pragma once
 
 #include <stddef.h>  // size_t
+#include <stdint.h>  // uint8_t
 #include <stdlib.h>  // free
 #include <string.h>  // strlen (for string wrappers)
 
 extern const size_t HASH_TABLE_DEFAULT_INITIAL_CAPACITY;
 extern const float HASH_TABLE_DEFAULT_RESIZE_THRESHOLD;
 extern const float HASH_TABLE_DEFAULT_RESIZE_FACTOR;
+extern const float HASH_TABLE_ROBIN_HOOD_RESIZE_THRESHOLD;
+extern const float HASH_TABLE_DEFAULT_TOMBSTONE_THRESHOLD;
+extern const size_t HASH_TABLE_DEFAULT_MAX_PROBE_LENGTH;
+extern const size_t HASH_TABLE_DEFAULT_MIGRATION_BATCH;
+extern const float HASH_TABLE_DEFAULT_SHRINK_THRESHOLD;
+extern const size_t HASH_TABLE_DEFAULT_KEY_ARENA_CHUNK_SIZE;
+
+// Largest capacity any table grows to, the largest power of two in a size_t
+#define HASH_TABLE_MAX_CAPACITY ((SIZE_MAX >> 1) + 1)
 
 // Function pointer type for custom value destructor
-// If NULL, free() will be used
+// If NULL, the table's allocator is used (free() by default)
 // If provided, this function will be called to clean up values
 typedef void (*value_destructor_t)(void *value);
 
+// Function pointer type for a custom key hash function
+// Called with the key bytes, the table's seed and the context pointer given at creation
+// Must return the same hash for equal keys (same bytes) for the lifetime of the table
+// See hash_table_hash.h for the built-in hash functions
+typedef size_t (*hash_function_t)(const void *key, size_t key_size, uint64_t seed, void *context);
+
+// Function pointer type for a custom key equality function
+// Called with a stored key, the key being looked up and the same context pointer as the hash function
+// Returns non-zero if the keys are equal; keys of different sizes may compare equal
+// Keys that compare equal must hash equally (pair it with a matching hash_function_t)
+typedef int (*key_equal_t)(const void *stored_key, size_t stored_key_size, const void *key, size_t key_size, void *context);
+
+// Allocator used for everything a table allocates: the table itself, its slot arrays (unless
+// options.huge_pages maps them), key copies and key arena chunks, and the value copies made by insert_copy()
+// Each function gets the context pointer (e.g. a jemalloc arena or a per-thread pool)
+// - allocate: like malloc, returns NULL on failure
+// - release:  like free, never called with NULL
+// Values without a destructor are released with it too, so values passed to insert()
+// must come from the same allocator
+typedef struct hash_table_allocator {
+    void *(*allocate)(size_t size, void *context);
+    void (*release)(void *ptr, void *context);
+    void *context;
+} hash_table_allocator_t;
+
+// Memory layout of the per-slot data
+// HASH_TABLE_LAYOUT_SPLIT keeps keys, key sizes and values in parallel arrays
+// HASH_TABLE_LAYOUT_INTERLEAVED packs hash, key size, key and value of a slot together,
+// so a successful lookup touches one slot instead of one cache line per array
+typedef enum hash_table_layout {
+    HASH_TABLE_LAYOUT_SPLIT,
+    HASH_TABLE_LAYOUT_INTERLEAVED
+} hash_table_layout_t;
+
+// Keys up to this many bytes are stored directly in the slot instead of a heap copy
+#define HASH_TABLE_INLINE_KEY_SIZE 16
+
+// Stored key: inline bytes for small keys, owned heap (or key arena) copy for larger ones
+// Which member is live is decided by the key size alone
+typedef union hash_table_key {
+    void *ptr;                                       // Heap or key arena copy (key_size > HASH_TABLE_INLINE_KEY_SIZE)
+    unsigned char bytes[HASH_TABLE_INLINE_KEY_SIZE]; // Inline copy (key_size <= HASH_TABLE_INLINE_KEY_SIZE)
+} hash_table_key_t;
+
+// Collision resolution policy
+// HASH_TABLE_PROBING_LINEAR places a new key in the first free slot of its probe sequence
+// HASH_TABLE_PROBING_ROBIN_HOOD lets a new key take the slot of an entry that is closer to its
+// home slot, keeping probe distances even. Lookups stop as soon as they pass an entry closer to
+// home than the key would be, so misses stay cheap at high load (see
+// HASH_TABLE_ROBIN_HOOD_RESIZE_THRESHOLD).
+typedef enum hash_table_probing {
+    HASH_TABLE_PROBING_LINEAR,
+    HASH_TABLE_PROBING_ROBIN_HOOD
+} hash_table_probing_t;
+
+// How hash_table_remove() frees a slot
+// HASH_TABLE_DELETION_BACKWARD_SHIFT moves later entries of the cluster back into the hole
+// HASH_TABLE_DELETION_TOMBSTONE marks the slot deleted in O(1); once tombstones pass
+// tombstone_threshold of the capacity the table is cleaned up in place, without growing
+// Robin Hood tables always use backward shift
+typedef enum hash_table_deletion {
+    HASH_TABLE_DELETION_BACKWARD_SHIFT,
+    HASH_TABLE_DELETION_TOMBSTONE
+} hash_table_deletion_t;
+
+// One slot of the interleaved layout (defined in hash_table.c)
+typedef struct hash_table_slot hash_table_slot_t;
+
+// Key arena of a table (shared with the old storage copy during an incremental resize)
+typedef struct hash_table_key_arena {
+    struct hash_table_key_arena_chunk *chunks; // Chunk list, the current one first (defined in hash_table.c)
+    size_t chunk_size;                         // Data bytes per regular chunk
+    size_t live;                               // Bytes held by stored keys
+    size_t dead;                               // Bytes of removed keys not reclaimed yet
+    hash_table_allocator_t allocator;          // Allocator of the owning table
+} hash_table_key_arena_t;
+
+// Creation options for hash_table_create_with_options()
+// Start from hash_table_default_options() and override the fields you need
+typedef struct hash_table_options {
+    size_t initial_capacity;             // Initial number of slots
+    float resize_threshold;              // Load factor that triggers a resize
+    float resize_factor;                 // Capacity multiplier on resize
+    value_destructor_t value_destructor; // Custom destructor for values (NULL releases them with the allocator)
+    hash_table_layout_t layout;          // Slot memory layout
+    size_t value_size;                   // Fixed value size in bytes, values stored inline (0 = pointer values)
+    hash_table_probing_t probing;        // Collision resolution policy
+    hash_table_deletion_t deletion;      // Deletion policy (linear probing only)
+    float tombstone_threshold;           // Fraction of capacity in tombstones that triggers an in-place cleanup
+    hash_function_t hash_function;       // Key hash function (NULL uses hash_table_hash_fnv_1a)
+    void *hash_context;                  // Context pointer passed to hash_function and key_equal
+    uint64_t seed;                       // Seed passed to hash_function
+    int random_seed;                     // Non-zero to draw a random seed for this table (overrides seed)
+    size_t max_probe_length;             // Insert probe distance that triggers a reseed and rehash (0 = never)
+    key_equal_t key_equal;               // Key equality function (NULL compares key size and bytes)
+    size_t migration_batch;              // Old slots migrated per operation while resizing (0 = rehash all at once)
+    float shrink_threshold;              // Load factor below which a remove halves the capacity (0 = never shrink)
+    size_t key_arena_chunk_size;         // Bytes per key arena chunk for keys stored out of line (0 = one malloc per key)
+    const hash_table_allocator_t *allocator; // Allocator for all table memory (NULL uses malloc and free), copied
+    int huge_pages;                      // Non-zero to mmap large slot arrays with MADV_HUGEPAGE and grow them with mremap
+} hash_table_options_t;
+
 // Main hash table structure
 // Contains the size, capacity, keys, key sizes, and values for the hash tables
 // The hash table uses linear probing for collision resolution
+// Power-of-two capacities (the default) map hashes to slots with Fibonacci hashing and a bit mask;
+// any other capacity falls back to hash % capacity
+// Each slot has a control byte holding 7 bits of the key's hash (or an empty/deleted marker),
+// and probing scans a whole group of control bytes per step with SIMD (see hash_table_group.h)
+// An occupancy bitmap mirrors which slots are full, so iteration, clear and destroy skip
+// 64 empty slots per word instead of reading every control byte
 // Keys are stored as c-strings, and values are stored as void pointers 
 // key is copied into the hash table, so it must be a valid c-string
+// (keys up to HASH_TABLE_INLINE_KEY_SIZE bytes are copied into the slot itself, larger ones to the heap)
 // value is moved into the hash table, so the hash table takes ownership of it
 // and is responsible for freeing it
 //
@@ -32,19 +151,92 @@ typedef void (*value_destructor_t)(void *value);
 // - insert_copy() is for trivially copyable types (primitives, simple structs)
 // - insert() is for when you want move semantics (transfer ownership of heap-allocated data)
 //
+// FIXED VALUE SIZE MODE (options.value_size > 0):
+// - Values are stored inline in a value slab owned by the table, no per-value allocation
+// - get() and emplace() return pointers into the slab, valid until the next insert, remove or clear
+// - insert_copy() copies value_size bytes into the slab (value_size must match the table's)
+// - insert() copies value_size bytes into the slab and then frees the passed buffer
+// - The destructor (if provided) is called on the slab copy for cleanup, values are never freed
+//
 // GENERIC KEY SUPPORT:
 // - Keys can be any trivially copyable type (strings, ints, structs, etc.)
 // - Keys are stored as raw bytes and compared with memcmp
+// - options.key_equal (with a matching options.hash_function) replaces the byte comparison,
+//   e.g. for case-insensitive strings, structs with padding, or keys that point to external data
+//   (the first inserted form of a key is the one that stays stored)
 // - For string keys, use strlen(key)+1 as the key_size to include null terminator
+//
+// INCREMENTAL RESIZE (options.migration_batch > 0):
+// - Growing (or shrinking) allocates the new storage but leaves the entries in the old one
+// - Every insert, get and remove then moves up to migration_batch old slots, and lookups
+//   check both storages until the old one is empty, so no single call rehashes the whole table
+// - In fixed value size mode a get can move other values, so returned pointers are only
+//   valid until the next operation on the table while a resize is in progress
+//
+// KEY ARENA (options.key_arena_chunk_size > 0, e.g. HASH_TABLE_DEFAULT_KEY_ARENA_CHUNK_SIZE):
+// - Keys too large to store inline are bump-allocated from chunks owned by the table
+//   instead of getting a malloc each
+// - Clear and destroy release the chunks wholesale instead of freeing every key
+// - Removed keys leave dead bytes behind; once those outweigh the live keys (and fill at least
+//   a chunk), a remove copies the live keys into fresh chunks and frees the old ones
+// - Stored keys are aligned like malloc'd memory, so key_equal can read them as structs
+//
+// HUGE PAGES (options.huge_pages != 0):
+// - Slot storage of 2 MiB or more is mapped with mmap and madvise(MADV_HUGEPAGE), so lookups in
+//   large tables miss the TLB far less often (needs transparent huge pages in madvise or always mode)
+// - Growing a mapped table with linear probing and no incremental resize extends the arrays
+//   with mremap and rehashes in place, without a second copy of the storage
+// - Falls back to the allocator where mmap is unavailable (non-Linux) or fails
+//
+// SHRINKING (options.shrink_threshold > 0, e.g. HASH_TABLE_DEFAULT_SHRINK_THRESHOLD):
+// - A remove that leaves the load below shrink_threshold halves the capacity, but never below
+//   the initial capacity
+// - It only halves if the load afterwards is at most half the resize threshold, so alternating
+//   inserts and removes around either threshold cannot grow and shrink the table back and forth
+// - hash_table_clear also returns the storage to the initial capacity
+//
+// UNTRUSTED KEYS:
+// - Use hash_table_hash_siphash with options.random_seed, so colliding keys cannot be precomputed
+// - Set options.max_probe_length (e.g. HASH_TABLE_DEFAULT_MAX_PROBE_LENGTH) so an insert that lands
+//   that far from its home slot reseeds the table and rehashes it in place
 typedef struct hash_table {
     size_t capacity;        // Capacity of the hash table
-    void **keys;            // Array of keys as void* (generic byte arrays)
+    uint8_t *ctrl;          // Array of control bytes (capacity + HASH_TABLE_GROUP_WIDTH - 1, tail mirrors the start)
+    uint64_t *occupied;     // Occupancy bitmap, bit i set when slot i is full (64 slots per word)
+    size_t *hashes;         // Array of cached full key hashes
+    hash_table_key_t *keys; // Array of keys (generic byte arrays, small ones stored inline)
     size_t *key_sizes;      // Array of key sizes in bytes
     void **values;          // Array of values
+    hash_table_slot_t *slots; // Array of slots (interleaved layout only, the four arrays above are NULL)
+    unsigned char *value_data; // Value slab, capacity * value size bytes (fixed value size mode only, values is NULL)
     size_t size;            // Size of the hash table
+    size_t _mask;           // capacity - 1 (power-of-two capacities only)
+    unsigned _hash_shift;   // Shift applied after Fibonacci mixing (0 when capacity is not a power of two)
     float _resize_threshold; // Resize threshold
     float _resize_factor;    // Resize factor
     value_destructor_t _value_destructor; // Custom destructor for values
+    hash_table_layout_t _layout; // Slot memory layout
+    size_t _value_size;      // Fixed value size (0 when values are pointers)
+    unsigned char *_value_scratch; // Two values of scratch space for moving inline values around
+    hash_table_probing_t _probing; // Collision resolution policy
+    hash_table_deletion_t _deletion; // Deletion policy
+    size_t _tombstones;      // Number of slots marked deleted
+    float _tombstone_threshold; // Tombstone fraction of capacity that triggers an in-place cleanup
+    hash_function_t _hash_function; // Key hash function
+    void *_hash_context;     // Context pointer passed to the hash and key equality functions
+    uint64_t _seed;          // Seed passed to the hash function
+    size_t _max_probe_length; // Configured probe distance that triggers a reseed (0 = never)
+    size_t _probe_limit;     // Current reseed trigger, doubled after each reseed until the table grows
+    key_equal_t _key_equal;  // Key equality function (NULL compares key size and bytes)
+    struct hash_table *_old; // Storage being migrated by an incremental resize (NULL when none)
+    size_t _migration_batch; // Old slots migrated per operation (0 = no incremental resize)
+    size_t _migrate_index;   // Next old slot to migrate
+    float _shrink_threshold; // Load factor below which a remove halves the capacity (0 = never shrink)
+    size_t _min_capacity;    // Capacity automatic shrinking stops at (the initial capacity)
+    hash_table_key_arena_t *_key_arena; // Chunks holding out-of-line keys (NULL = one malloc per key)
+    hash_table_allocator_t _allocator; // Allocator for all table memory
+    int _huge_pages;         // Map large slot storage with mmap and huge pages
+    int _slots_mapped;       // Is the current slot storage mapped (instead of from the allocator)?
 } hash_table_t;
 
 // Create a new hash table with default initial capacity (16), resize threshold (0.5), and resize factor (2.0)
@@ -70,6 +262,23 @@ hash_table_t *hash_table_create_with_parameters(size_t capacity, float resize_th
 // Use with caution
 hash_table_t *hash_table_create_with_parameters_and_destructor(size_t capacity, float resize_threshold, float resize_factor, value_destructor_t destructor);
 
+// Create a new hash table with default parameters and a custom key hash function
+// The context pointer is passed to every call of the hash function (may be NULL)
+// Pass NULL for hasher to use the default (hash_table_hash_fnv_1a)
+// For long keys, hash_table_hash_wyhash or hash_table_hash_crc32c are much faster
+hash_table_t *hash_table_create_with_hasher(hash_function_t hasher, void *context);
+
+// Create a new hash table with default parameters and a custom allocator (copied)
+// Pass NULL to use malloc and free (same as hash_table_create())
+hash_table_t *hash_table_create_with_allocator(const hash_table_allocator_t *allocator);
+
+// Get the default creation options (same defaults as hash_table_create())
+hash_table_options_t hash_table_default_options(void);
+
+// Create a new hash table from an options struct
+// Returns NULL on allocation failure
+hash_table_t *hash_table_create_with_options(const hash_table_options_t *options);
+
 // Destroy the hash table and free all associated memory
 void hash_table_destroy(hash_table_t *table);
 
@@ -93,21 +302,54 @@ int hash_table_insert(hash_table_t *table, const void *key, size_t key_size, voi
 //
 // This is convenient for trivially copyable types like primitives and simple structs
 //
-// Returns 0 on success, 1 on failure
+// Returns 0 on success, 1 on failure (including a value_size mismatch in fixed value size mode)
 // On failure, the hash table remains unchanged
 int hash_table_insert_copy(hash_table_t *table, const void *key, size_t key_size, const void *value, size_t value_size);
 
+// Insert n key-value pairs by copying, like n calls to hash_table_insert_copy
+// (keys[i] of key_sizes[i] bytes, values[i] of value_size bytes; later duplicates update earlier ones)
+// The table is first sized once for size + n entries, so the batch causes at most one resize
+// (keys that already exist count too, so a batch of mostly updates can leave spare capacity)
+// Keys are then hashed and prefetched 32 at a time before being inserted, like hash_table_get_batch
+// During an incremental resize, reserving finishes the migration first
+//
+// results[i] (if results is not NULL) is set to 0 if pair i was inserted, 1 if it failed
+// Returns 0 if every pair was inserted, 1 if any failed (failed pairs leave the table unchanged)
+int hash_table_insert_batch(hash_table_t *table, const void *const keys[], const size_t key_sizes[],
+                            const void *const values[], size_t value_size, size_t n, int results[]);
+
 // Retrieve the value associated with a given key (generic key)
 // Returns NULL if the key does not exist
 //
 // The returned value is an alias of the value and should not be freed directly
+// In fixed value size mode this is a pointer into the table's value storage
 void *hash_table_get(hash_table_t *table, const void *key, size_t key_size);
 
+// Retrieve the values of n keys at once: values[i] is set to what hash_table_get would return
+// for keys[i] and key_sizes[i] (NULL if missing)
+// Keys are handled 32 at a time: all are hashed and their control bytes and candidate slots
+// prefetched before any is probed, so the cache misses of different keys overlap instead of
+// each get waiting on its own; faster than n gets once the table outgrows the cache
+// The pointers are valid until the next insert, remove or clear, also during an incremental resize
+// Returns the number of keys found
+size_t hash_table_get_batch(hash_table_t *table, const void *const keys[], const size_t key_sizes[], size_t n, void *values[]);
+
+// Get a pointer to the inline value storage for a key, inserting the key if needed (fixed value size mode)
+// A newly inserted value is zero-filled; an existing value is left as is
+//
+// Returns NULL on failure or if the table does not use fixed value size mode
+// The pointer is valid until the next insert, remove or clear
+void *hash_table_emplace(hash_table_t *table, const void *key, size_t key_size);
+
 // Remove a key-value pair from the hash table (generic key)
 // Does nothing if the key does not exist
 //
 // Frees the key and value associated with the key
 // Any remaining aliases to the value will become dangling pointers
+//
+// Uses backward-shift deletion by default: later entries of the same cluster are moved back
+// to fill the hole, so probe chains stay intact and no deleted markers accumulate
+// Tables created with HASH_TABLE_DELETION_TOMBSTONE mark the slot deleted instead
 void hash_table_remove(hash_table_t *table, const void *key, size_t key_size);
 
 // Check if the hash table contains a given key (generic key)
@@ -120,11 +362,95 @@ size_t hash_table_size(hash_table_t *table);
 // Get the current capacity of the hash table
 size_t hash_table_capacity(hash_table_t *table);
 
+// Make room for at least n entries, so inserting up to n entries does no further resizes
+// Sizes the table once for n entries at its resize threshold (rounded up to a power of two
+// for power-of-two tables); does nothing if the table is already big enough
+//
+// Returns 0 on success, 1 on failure
+// On failure, the hash table remains unchanged
+int hash_table_reserve(hash_table_t *table, size_t n);
+
+// Shrink the table to the smallest capacity that holds its current entries at its resize threshold
+// Useful after removing most entries, since tables never shrink on their own
+//
+// Returns 0 on success, 1 on failure
+// On failure, the hash table remains unchanged
+int hash_table_shrink_to_fit(hash_table_t *table);
+
 // Clear all entries in the hash table
 // Frees all keys and values
+// With a shrink threshold set, the capacity also goes back to the initial capacity
 // Any remaining aliases to the values will become dangling pointers
 void hash_table_clear(hash_table_t *table);
 
+// ============================================================================
+// Iteration
+// ============================================================================
+
+// Iterator over all entries, in slot order (jumping between full slots with the occupancy bitmap)
+// The table must not be modified while iterating; while an incremental resize is in
+// progress, get() moves entries too, so only iterate without touching the table
+//
+// Example:
+//     hash_table_iter_t iter;
+//     hash_table_iter_init(&iter, table);
+//     while (hash_table_iter_next(&iter)) {
+//         use(iter.key, iter.key_size, iter.value);
+//     }
+typedef struct hash_table_iter {
+    const void *key;         // Current key
+    size_t key_size;         // Current key size in bytes
+    void *value;             // Current value (points into the value slab in fixed value size mode)
+    hash_table_t *_table;    // Table being iterated
+    hash_table_t *_storage;  // Storage being walked (the table, then the old storage of an incremental resize)
+    size_t _word;            // Current word of the storage's occupancy bitmap
+    uint64_t _pending;       // Full slots of the current word not visited yet
+} hash_table_iter_t;
+
+// Start iterating over a table
+void hash_table_iter_init(hash_table_iter_t *iter, hash_table_t *table);
+
+// Move to the next entry, setting iter->key, iter->key_size and iter->value
+// Returns 1 if there is a next entry, 0 when the iteration is done
+int hash_table_iter_next(hash_table_iter_t *iter);
+
+// Function pointer type for the callback of hash_table_scan
+// Must not modify the table
+typedef void (*scan_callback_t)(const void *key, size_t key_size, void *value, void *context);
+
+// Visit a chunk of the table's entries, resuming from a cursor (like Redis SCAN)
+// Start with cursor 0 and pass each returned cursor to the next call; 0 means the scan is done
+// count is roughly how many slots to cover per call
+//
+// Unlike an iterator, the cursor stays valid while the table is modified between calls:
+// every entry that is in the table for the whole scan is visited at least once, even if the
+// table grows, shrinks or migrates in between. Entries may be visited more than once after a
+// shrink, and entries inserted or removed during the scan may or may not be visited
+// The cursor is a position in hash order, so the guarantee only holds for power-of-two
+// capacities (the default) and is lost if the table reseeds (options.max_probe_length)
+size_t hash_table_scan(hash_table_t *table, size_t cursor, size_t count, scan_callback_t callback, void *context);
+
+// ============================================================================
+// Prehashed Operations
+// ============================================================================
+// Hash a key once with hash_table_hash, then pass the hash to the _prehashed variants,
+// which behave exactly like the functions without the suffix but skip hashing the key
+// (e.g. contains followed by insert, or routing keys to shards by hash before touching them)
+//
+// A hash is only valid for tables with the same hash function, seed and hash context as the
+// one that computed it, and only until that table reseeds (options.max_probe_length, during an
+// insert); a wrong hash makes the key look missing, or stores it where lookups will not find it
+
+// Hash a key with the table's hash function, seed and context (0 for a NULL table or key)
+size_t hash_table_hash(hash_table_t *table, const void *key, size_t key_size);
+
+int hash_table_insert_prehashed(hash_table_t *table, const void *key, size_t key_size, size_t hash, void *value);
+int hash_table_insert_copy_prehashed(hash_table_t *table, const void *key, size_t key_size, size_t hash,
+                                     const void *value, size_t value_size);
+void *hash_table_get_prehashed(hash_table_t *table, const void *key, size_t key_size, size_t hash);
+void hash_table_remove_prehashed(hash_table_t *table, const void *key, size_t key_size, size_t hash);
+char hash_table_contains_prehashed(hash_table_t *table, const void *key, size_t key_size, size_t hash);
+
 // ============================================================================
 // String Key Convenience Functions
 // ============================================================================
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================================================
+// Control Byte Groups
+// ============================================================================
+// Every slot has one control byte. A full slot stores the top 7 bits of its
+// key's hash (the "h2" tag, 0x00-0x7F); empty and deleted slots use markers
+// with the high bit set. Probing loads a whole group of control bytes at once
+// and turns it into a bitmask (bit i = slot index + i), so non-matching slots
+// are rejected without touching keys.
+//
+// The group width is picked at compile time:
+// - AVX2: 32 slots per step
+// - SSE2: 16 slots per step
+// - Otherwise: portable scalar loop over 16 slots
+//
+// The control array holds HASH_TABLE_GROUP_WIDTH - 1 extra bytes after the last
+// slot that mirror the first slots, so a group load never needs to wrap.
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define HASH_TABLE_GROUP_WIDTH 32
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define HASH_TABLE_GROUP_WIDTH 16
+#else
+#define HASH_TABLE_GROUP_WIDTH 16
+#endif
+
+#define HASH_TABLE_CTRL_EMPTY ((uint8_t)0x80)
+#define HASH_TABLE_CTRL_DELETED ((uint8_t)0xFE)
+
+// Fibonacci hashing multiplier (2^w / golden ratio) for the width of size_t
+// Power-of-two tables take their home slot from the high bits of hash * multiplier
+#if SIZE_MAX > 0xFFFFFFFFu
+#define HASH_TABLE_FIBONACCI_MULTIPLIER ((size_t)11400714819323198485ull)
+#else
+#define HASH_TABLE_FIBONACCI_MULTIPLIER ((size_t)2654435769u)
+#endif
+
+// Top 7 bits of the hash, stored in the control byte of a full slot
+static inline uint8_t hash_table_h2(size_t hash) {
+    return (uint8_t)(hash >> (sizeof(size_t) * CHAR_BIT - 7));
+}
+
+// Bitmask over one group, bit i set when slot (group start + i) matches
+typedef uint32_t hash_table_mask_t;
+
+// Is this control byte a full slot (as opposed to empty or deleted)?
+static inline int hash_table_ctrl_is_full(uint8_t ctrl) {
+    return (ctrl & 0x80) == 0;
+}
+
+#if defined(__AVX2__)
+
+static inline hash_table_mask_t hash_table_group_match(const uint8_t *group, uint8_t h2) {
+    __m256i ctrl = _mm256_loadu_si256((const __m256i *)group);
+    return (hash_table_mask_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(ctrl, _mm256_set1_epi8((char)h2)));
+}
+
+static inline hash_table_mask_t hash_table_group_match_empty(const uint8_t *group) {
+    __m256i ctrl = _mm256_loadu_si256((const __m256i *)group);
+    return (hash_table_mask_t)_mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(ctrl, _mm256_set1_epi8((char)HASH_TABLE_CTRL_EMPTY)));
+}
+
+// Empty or deleted: both markers have the high bit set, full slots do not
+static inline hash_table_mask_t hash_table_group_match_available(const uint8_t *group) {
+    return (hash_table_mask_t)_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i *)group));
+}
+
+#elif defined(__SSE2__)
+
+static inline hash_table_mask_t hash_table_group_match(const uint8_t *group, uint8_t h2) {
+    __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+    return (hash_table_mask_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)h2)));
+}
+
+static inline hash_table_mask_t hash_table_group_match_empty(const uint8_t *group) {
+    __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+    return (hash_table_mask_t)_mm_movemask_epi8(
+        _mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)HASH_TABLE_CTRL_EMPTY)));
+}
+
+// Empty or deleted: both markers have the high bit set, full slots do not
+static inline hash_table_mask_t hash_table_group_match_available(const uint8_t *group) {
+    return (hash_table_mask_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)group));
+}
+
+#else
+
+static inline hash_table_mask_t hash_table_group_match(const uint8_t *group, uint8_t h2) {
+    hash_table_mask_t mask = 0;
+    for (unsigned i = 0; i < HASH_TABLE_GROUP_WIDTH; i++) {
+        mask |= (hash_table_mask_t)(group[i] == h2) << i;
+    }
+    return mask;
+}
+
+static inline hash_table_mask_t hash_table_group_match_empty(const uint8_t *group) {
+    return hash_table_group_match(group, HASH_TABLE_CTRL_EMPTY);
+}
+
+// Empty or deleted: both markers have the high bit set, full slots do not
+static inline hash_table_mask_t hash_table_group_match_available(const uint8_t *group) {
+    hash_table_mask_t mask = 0;
+    for (unsigned i = 0; i < HASH_TABLE_GROUP_WIDTH; i++) {
+        mask |= (hash_table_mask_t)(group[i] >> 7) << i;
+    }
+    return mask;
+}
+
+#endif
+
+// Index of the lowest set bit (mask must be non-zero)
+static inline unsigned hash_table_mask_first(hash_table_mask_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctz(mask);
+#else
+    unsigned index = 0;
+    while ((mask & 1u) == 0) {
+        mask >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
@@ -0,0 +1,358 @@
+#include "hash_table_hash.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__STDC_NO_ATOMICS__)
+#define HASH_TABLE_ATOMIC
+#else
+#include <stdatomic.h>
+#define HASH_TABLE_ATOMIC _Atomic
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define HASH_TABLE_HAVE_CRC32C_DISPATCH 1
+#endif
+
+// Unaligned little-endian-agnostic loads (the hash only needs to be consistent per process)
+static inline uint64_t hash_table_read64(const unsigned char *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t hash_table_read32(const unsigned char *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// ============================================================================
+// FNV-1a
+// ============================================================================
+
+size_t hash_table_hash_fnv_1a(const void *key, size_t key_size, uint64_t seed, void *context) {
+    (void)context;
+#if SIZE_MAX > 0xFFFFFFFFu
+    const size_t fnv_prime = (size_t)0x100000001B3ull;
+    size_t hash = (size_t)(0xCBF29CE484222325ull ^ seed);
+#else
+    const size_t fnv_prime = 0x1000193;
+    size_t hash = (size_t)(0x811C9DC5u ^ seed ^ (seed >> 32));
+#endif
+    const unsigned char *bytes = (const unsigned char *)key;
+
+    for (size_t i = 0; i < key_size; i++) {
+        hash ^= bytes[i];
+        hash *= fnv_prime;
+    }
+
+    return hash;
+}
+
+// ============================================================================
+// wyhash-style
+// ============================================================================
+// Follows the structure of wyhash (Wang Yi, public domain): keys up to 16 bytes are
+// read with at most four overlapping loads, longer keys are consumed 16 or 48 bytes per
+// step, and every step is a 64x64->128-bit multiply folded back to 64 bits.
+
+static const uint64_t hash_table_wy_secret[4] = {
+    0x2D358DCCAA6C78A5ull, 0x8BB84B93962EACC9ull, 0x4B33A62ED433D4A3ull, 0x4D5A2DA51DE1AA47ull
+};
+
+// 64x64 -> 128-bit multiply, low half into *a and high half into *b
+static inline void hash_table_wy_mum(uint64_t *a, uint64_t *b) {
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = (__uint128_t)*a * *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32);
+    uint64_t carry = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    carry += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+#endif
+}
+
+static inline uint64_t hash_table_wy_mix(uint64_t a, uint64_t b) {
+    hash_table_wy_mum(&a, &b);
+    return a ^ b;
+}
+
+size_t hash_table_hash_wyhash(const void *key, size_t key_size, uint64_t seed, void *context) {
+    (void)context;
+    const unsigned char *p = (const unsigned char *)key;
+    const uint64_t *secret = hash_table_wy_secret;
+    uint64_t a;
+    uint64_t b;
+
+    seed ^= hash_table_wy_mix(seed ^ secret[0], secret[1]);
+
+    if (key_size <= 16) {
+        if (key_size >= 4) {
+            size_t shift = (key_size >> 3) << 2;
+            a = (hash_table_read32(p) << 32) | hash_table_read32(p + shift);
+            b = (hash_table_read32(p + key_size - 4) << 32) | hash_table_read32(p + key_size - 4 - shift);
+        } else if (key_size > 0) {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[key_size >> 1] << 8) | p[key_size - 1];
+            b = 0;
+        } else {
+            a = 0;
+            b = 0;
+        }
+    } else {
+        size_t remaining = key_size;
+        if (remaining > 48) {
+            uint64_t see1 = seed;
+            uint64_t see2 = seed;
+            do {
+                seed = hash_table_wy_mix(hash_table_read64(p) ^ secret[1], hash_table_read64(p + 8) ^ seed);
+                see1 = hash_table_wy_mix(hash_table_read64(p + 16) ^ secret[2], hash_table_read64(p + 24) ^ see1);
+                see2 = hash_table_wy_mix(hash_table_read64(p + 32) ^ secret[3], hash_table_read64(p + 40) ^ see2);
+                p += 48;
+                remaining -= 48;
+            } while (remaining > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (remaining > 16) {
+            seed = hash_table_wy_mix(hash_table_read64(p) ^ secret[1], hash_table_read64(p + 8) ^ seed);
+            p += 16;
+            remaining -= 16;
+        }
+        a = hash_table_read64(p + remaining - 16);
+        b = hash_table_read64(p + remaining - 8);
+    }
+
+    a ^= secret[1];
+    b ^= seed;
+    hash_table_wy_mum(&a, &b);
+    return (size_t)hash_table_wy_mix(a ^ secret[0] ^ key_size, b ^ secret[1]);
+}
+
+// ============================================================================
+// CRC32C
+// ============================================================================
+// Even 8-byte words feed one CRC lane and odd words the other, so the two lanes are
+// independent dependency chains (the crc32 instruction has a 3 cycle latency but a
+// throughput of one per cycle). The lanes are then joined and mixed so the high bits,
+// which pick the home slot and the control byte tag, are as good as the low bits.
+
+#define HASH_TABLE_CRC32C_POLY 0x82F63B78u
+
+static inline uint32_t hash_table_crc32c_u8_sw(uint32_t crc, uint8_t byte) {
+    crc ^= byte;
+    for (int bit = 0; bit < 8; bit++) {
+        crc = (crc >> 1) ^ (HASH_TABLE_CRC32C_POLY & (0u - (crc & 1u)));
+    }
+    return crc;
+}
+
+static inline uint32_t hash_table_crc32c_u64_sw(uint32_t crc, uint64_t word) {
+    for (int i = 0; i < 8; i++) {
+        crc = hash_table_crc32c_u8_sw(crc, (uint8_t)(word >> (8 * i)));
+    }
+    return crc;
+}
+
+// Join the two lanes and finish with a multiply/xorshift mix
+static inline size_t hash_table_crc32c_finish(uint32_t lane0, uint32_t lane1, size_t key_size) {
+    uint64_t hash = (((uint64_t)lane1 << 32) | lane0) ^ ((uint64_t)key_size * 0x9E3779B97F4A7C15ull);
+    hash ^= hash >> 32;
+    hash *= 0xD6E8FEB86659FD93ull;
+    hash ^= hash >> 32;
+    return (size_t)hash;
+}
+
+static size_t hash_table_crc32c_sw(const unsigned char *p, size_t key_size, uint64_t seed) {
+    uint32_t lane0 = (uint32_t)seed;
+    uint32_t lane1 = (uint32_t)(seed >> 32) ^ 0x9E3779B9u;
+    size_t i = 0;
+
+    for (; i + 16 <= key_size; i += 16) {
+        lane0 = hash_table_crc32c_u64_sw(lane0, hash_table_read64(p + i));
+        lane1 = hash_table_crc32c_u64_sw(lane1, hash_table_read64(p + i + 8));
+    }
+    if (i + 8 <= key_size) {
+        lane0 = hash_table_crc32c_u64_sw(lane0, hash_table_read64(p + i));
+        i += 8;
+    }
+    for (; i < key_size; i++) {
+        lane1 = hash_table_crc32c_u8_sw(lane1, p[i]);
+    }
+
+    return hash_table_crc32c_finish(lane0, lane1, key_size);
+}
+
+#if defined(HASH_TABLE_HAVE_CRC32C_DISPATCH)
+
+__attribute__((target("sse4.2")))
+static size_t hash_table_crc32c_hw(const unsigned char *p, size_t key_size, uint64_t seed) {
+    uint32_t lane0 = (uint32_t)seed;
+    uint32_t lane1 = (uint32_t)(seed >> 32) ^ 0x9E3779B9u;
+    size_t i = 0;
+
+#if defined(__x86_64__)
+    for (; i + 16 <= key_size; i += 16) {
+        lane0 = (uint32_t)_mm_crc32_u64(lane0, hash_table_read64(p + i));
+        lane1 = (uint32_t)_mm_crc32_u64(lane1, hash_table_read64(p + i + 8));
+    }
+    if (i + 8 <= key_size) {
+        lane0 = (uint32_t)_mm_crc32_u64(lane0, hash_table_read64(p + i));
+        i += 8;
+    }
+#else
+    for (; i + 16 <= key_size; i += 16) {
+        lane0 = _mm_crc32_u32(_mm_crc32_u32(lane0, (uint32_t)hash_table_read32(p + i)), (uint32_t)hash_table_read32(p + i + 4));
+        lane1 = _mm_crc32_u32(_mm_crc32_u32(lane1, (uint32_t)hash_table_read32(p + i + 8)), (uint32_t)hash_table_read32(p + i + 12));
+    }
+    if (i + 8 <= key_size) {
+        lane0 = _mm_crc32_u32(_mm_crc32_u32(lane0, (uint32_t)hash_table_read32(p + i)), (uint32_t)hash_table_read32(p + i + 4));
+        i += 8;
+    }
+#endif
+    for (; i < key_size; i++) {
+        lane1 = _mm_crc32_u8(lane1, p[i]);
+    }
+
+    return hash_table_crc32c_finish(lane0, lane1, key_size);
+}
+
+#endif
+
+size_t hash_table_hash_crc32c(const void *key, size_t key_size, uint64_t seed, void *context) {
+    (void)context;
+#if defined(HASH_TABLE_HAVE_CRC32C_DISPATCH)
+    if (__builtin_cpu_supports("sse4.2")) {
+        return hash_table_crc32c_hw((const unsigned char *)key, key_size, seed);
+    }
+#endif
+    return hash_table_crc32c_sw((const unsigned char *)key, key_size, seed);
+}
+
+// ============================================================================
+// SipHash-1-3
+// ============================================================================
+// Jean-Philippe Aumasson and Daniel J. Bernstein's SipHash with one compression round
+// per word and three finalization rounds (the variant CPython and Rust use for hash tables)
+
+static inline uint64_t hash_table_rotl64(uint64_t x, unsigned r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+// Little-endian load, so results are the same on every platform
+static inline uint64_t hash_table_read64_le(const unsigned char *p) {
+    return (uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16) | ((uint64_t)p[3] << 24) |
+           ((uint64_t)p[4] << 32) | ((uint64_t)p[5] << 40) | ((uint64_t)p[6] << 48) | ((uint64_t)p[7] << 56);
+}
+
+#define HASH_TABLE_SIPROUND(v0, v1, v2, v3) \
+    do { \
+        v0 += v1; v1 = hash_table_rotl64(v1, 13); v1 ^= v0; v0 = hash_table_rotl64(v0, 32); \
+        v2 += v3; v3 = hash_table_rotl64(v3, 16); v3 ^= v2; \
+        v0 += v3; v3 = hash_table_rotl64(v3, 21); v3 ^= v0; \
+        v2 += v1; v1 = hash_table_rotl64(v1, 17); v1 ^= v2; v2 = hash_table_rotl64(v2, 32); \
+    } while (0)
+
+size_t hash_table_hash_siphash(const void *key, size_t key_size, uint64_t seed, void *context) {
+    const unsigned char *p = (const unsigned char *)key;
+    uint64_t k0 = seed;
+    uint64_t k1 = seed ^ 0x9E3779B97F4A7C15ull;
+    if (context != NULL) {
+        const hash_table_siphash_key_t *sip_key = (const hash_table_siphash_key_t *)context;
+        k0 = sip_key->k0 ^ seed;
+        k1 = sip_key->k1;
+    }
+
+    uint64_t v0 = k0 ^ 0x736F6D6570736575ull;
+    uint64_t v1 = k1 ^ 0x646F72616E646F6Dull;
+    uint64_t v2 = k0 ^ 0x6C7967656E657261ull;
+    uint64_t v3 = k1 ^ 0x7465646279746573ull;
+
+    size_t i = 0;
+    for (; i + 8 <= key_size; i += 8) {
+        uint64_t m = hash_table_read64_le(p + i);
+        v3 ^= m;
+        HASH_TABLE_SIPROUND(v0, v1, v2, v3);
+        v0 ^= m;
+    }
+
+    // Last word: remaining bytes plus the length in the top byte
+    uint64_t last = (uint64_t)key_size << 56;
+    for (size_t shift = 0; i < key_size; i++, shift += 8) {
+        last |= (uint64_t)p[i] << shift;
+    }
+    v3 ^= last;
+    HASH_TABLE_SIPROUND(v0, v1, v2, v3);
+    v0 ^= last;
+
+    v2 ^= 0xFF;
+    HASH_TABLE_SIPROUND(v0, v1, v2, v3);
+    HASH_TABLE_SIPROUND(v0, v1, v2, v3);
+    HASH_TABLE_SIPROUND(v0, v1, v2, v3);
+    return (size_t)(v0 ^ v1 ^ v2 ^ v3);
+}
+
+// ============================================================================
+// Random Seeds
+// ============================================================================
+// Seeds are SipHash outputs of an atomic counter under a process-wide secret key, so a
+// seed reveals nothing about the key or about other tables' seeds. The key is read from
+// /dev/urandom on first use; time, clock and address bits are always mixed in so a
+// missing /dev/urandom still gives different seeds per process.
+
+static HASH_TABLE_ATOMIC uint64_t hash_table_seed_k0;
+static HASH_TABLE_ATOMIC uint64_t hash_table_seed_k1;
+static HASH_TABLE_ATOMIC uint64_t hash_table_seed_counter;
+
+static void hash_table_seed_entropy(uint64_t entropy[2]) {
+    entropy[0] = 0;
+    entropy[1] = 0;
+
+    FILE *urandom = fopen("/dev/urandom", "rb");
+    if (urandom != NULL) {
+        if (fread(entropy, sizeof(uint64_t), 2, urandom) != 2) {
+            entropy[0] = 0;
+            entropy[1] = 0;
+        }
+        fclose(urandom);
+    }
+
+    uint64_t fallback[4] = {
+        (uint64_t)time(NULL),
+        (uint64_t)clock(),
+        (uint64_t)(uintptr_t)&fallback,
+        (uint64_t)(uintptr_t)&hash_table_seed_counter
+    };
+    entropy[0] ^= hash_table_hash_siphash(fallback, sizeof(fallback), 0, NULL);
+    entropy[1] ^= hash_table_hash_siphash(fallback, sizeof(fallback), 1, NULL);
+    entropy[1] |= 1; // A zero k1 marks the key as not yet set
+}
+
+uint64_t hash_table_random_seed(void) {
+    hash_table_siphash_key_t key;
+    key.k1 = hash_table_seed_k1;
+    if (key.k1 == 0) {
+        // Racing first calls may each store a key; any mix of their halves is still random
+        uint64_t entropy[2];
+        hash_table_seed_entropy(entropy);
+        hash_table_seed_k0 = entropy[0];
+        hash_table_seed_k1 = entropy[1];
+    }
+    key.k0 = hash_table_seed_k0;
+    key.k1 = hash_table_seed_k1;
+
+#if defined(__STDC_NO_ATOMICS__)
+    uint64_t counter = hash_table_seed_counter++;
+#else
+    uint64_t counter = atomic_fetch_add(&hash_table_seed_counter, 1);
+#endif
+    return hash_table_hash_siphash(&counter, sizeof(counter), 0, &key);
+}
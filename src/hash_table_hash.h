@@ -0,0 +1,76 @@
+#pragma once
+
+#include "hash_table.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================================================
+// Built-in Hash Functions
+// ============================================================================
+// All of these match hash_function_t and can be passed to
+// hash_table_create_with_hasher() or set as options.hash_function.
+// The context argument is unused by the built-ins, except for SipHash.
+
+// FNV-1a, one byte per step (64-bit offset basis and prime on 64-bit targets)
+// The seed is folded into the offset basis; seed 0 gives standard FNV-1a
+// Simple and portable, but slow for long keys
+size_t hash_table_hash_fnv_1a(const void *key, size_t key_size, uint64_t seed, void *context);
+
+// wyhash-style hash, 8-16 bytes per step using 64x64->128-bit multiplies
+// The fastest choice for medium and long keys on 64-bit targets
+size_t hash_table_hash_wyhash(const void *key, size_t key_size, uint64_t seed, void *context);
+
+// CRC32C based hash, two independent 32-bit CRC lanes over alternating 8-byte words,
+// combined and mixed into a full-width hash
+// Uses the SSE4.2 crc32 instruction when the CPU supports it (checked at runtime),
+// and an equivalent software CRC otherwise, so results do not depend on the CPU
+size_t hash_table_hash_crc32c(const void *key, size_t key_size, uint64_t seed, void *context);
+
+// Full 128-bit SipHash key, passed as the context of hash_table_hash_siphash
+typedef struct hash_table_siphash_key {
+    uint64_t k0;
+    uint64_t k1;
+} hash_table_siphash_key_t;
+
+// SipHash-1-3, a keyed hash whose collisions cannot be predicted without the key
+// Use it with a random seed (options.random_seed) when keys come from untrusted input
+// The key is derived from the seed, or if context points to a hash_table_siphash_key_t,
+// that key is used with the seed XORed into k0
+// Slower than wyhash and CRC32C, but still several bytes per cycle
+size_t hash_table_hash_siphash(const void *key, size_t key_size, uint64_t seed, void *context);
+
+// ============================================================================
+// Random Seeds
+// ============================================================================
+
+// Get a fresh random 64-bit seed
+// Seeds come from a process-wide generator keyed once from /dev/urandom
+// (falling back to time and address entropy), so this is cheap and never repeats a value
+// Safe to call from multiple threads where C11 atomics are available
+uint64_t hash_table_random_seed(void);
+
+// ============================================================================
+// Integer Mixers
+// ============================================================================
+// MurmurHash3 finalizers: every input bit affects every output bit, so the low bits
+// can index a power-of-two table directly. Both are bijections, so distinct keys never
+// collide on the full hash.
+
+static inline uint64_t hash_table_mix_u64(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDull;
+    key ^= key >> 33;
+    key *= 0xC4CEB9FE1A85EC53ull;
+    key ^= key >> 33;
+    return key;
+}
+
+static inline uint32_t hash_table_mix_u32(uint32_t key) {
+    key ^= key >> 16;
+    key *= 0x85EBCA6Bu;
+    key ^= key >> 13;
+    key *= 0xC2B2AE35u;
+    key ^= key >> 16;
+    return key;
+}
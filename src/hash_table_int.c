@@ -0,0 +1,350 @@
+#include "hash_table_int.h"
+#include "hash_table.h"
+#include "hash_table_hash.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+// Smallest power of two that is at least the requested capacity (and at least 1),
+// or 0 if it is above HASH_TABLE_MAX_CAPACITY
+static size_t hash_table_int_round_capacity(size_t capacity) {
+    if (capacity > HASH_TABLE_MAX_CAPACITY) return 0;
+    size_t rounded = 1;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    return rounded;
+}
+
+// Would one more entry in the slot array push it past the load threshold?
+static inline int hash_table_int_needs_growth(size_t slot_entries, size_t capacity) {
+    return (float)(slot_entries + 1) / capacity > HASH_TABLE_DEFAULT_RESIZE_THRESHOLD;
+}
+
+// ============================================================================
+// uint64_t Keys
+// ============================================================================
+
+static inline size_t hash_table_u64_home(const hash_table_u64_t *table, uint64_t key) {
+    return (size_t)hash_table_mix_u64(key) & table->_mask;
+}
+
+// Slot holding the key, or the empty slot that ends its probe sequence (key must not be 0)
+static inline size_t hash_table_u64_find(const hash_table_u64_t *table, uint64_t key) {
+    size_t index = hash_table_u64_home(table, key);
+    while (table->slots[index].key != key && table->slots[index].key != 0) {
+        index = (index + 1) & table->_mask;
+    }
+    return index;
+}
+
+// Allocate an empty slot array (all keys 0)
+// Returns 0 on success, 1 on failure (the table is unchanged)
+static int hash_table_u64_alloc_slots(hash_table_u64_t *table, size_t capacity) {
+    hash_table_u64_slot_t *slots = calloc(capacity, sizeof(hash_table_u64_slot_t));
+    if (slots == NULL) return 1;
+    table->slots = slots;
+    table->capacity = capacity;
+    table->_mask = capacity - 1;
+    return 0;
+}
+
+static int hash_table_u64_resize(hash_table_u64_t *table, size_t new_capacity) {
+    hash_table_u64_slot_t *old_slots = table->slots;
+    size_t old_capacity = table->capacity;
+
+    if (hash_table_u64_alloc_slots(table, new_capacity) != 0) {
+        fprintf(stderr, "Error: Failed to allocate memory for resized hash table.\n");
+        return 1;
+    }
+
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old_slots[i].key != 0) {
+            table->slots[hash_table_u64_find(table, old_slots[i].key)] = old_slots[i];
+        }
+    }
+
+    free(old_slots);
+    return 0;
+}
+
+hash_table_u64_t *hash_table_u64_create(void) {
+    return hash_table_u64_create_with_capacity(HASH_TABLE_DEFAULT_INITIAL_CAPACITY);
+}
+
+hash_table_u64_t *hash_table_u64_create_with_capacity(size_t capacity) {
+    capacity = hash_table_int_round_capacity(capacity);
+    if (capacity == 0) return NULL;
+    hash_table_u64_t *table = malloc(sizeof(hash_table_u64_t));
+    if (table == NULL) return NULL;
+    table->size = 0;
+    table->_has_zero_key = 0;
+    table->_zero_value = 0;
+    if (hash_table_u64_alloc_slots(table, capacity) != 0) {
+        free(table);
+        return NULL;
+    }
+    return table;
+}
+
+void hash_table_u64_destroy(hash_table_u64_t *table) {
+    if (table == NULL) return;
+    free(table->slots);
+    free(table);
+}
+
+int hash_table_u64_insert(hash_table_u64_t *table, uint64_t key, uint64_t value) {
+    if (table == NULL) return 1;
+
+    if (key == 0) {
+        table->size += !table->_has_zero_key;
+        table->_has_zero_key = 1;
+        table->_zero_value = value;
+        return 0;
+    }
+
+    size_t index = hash_table_u64_find(table, key);
+    if (table->slots[index].key == key) {
+        table->slots[index].value = value;
+        return 0;
+    }
+
+    if (hash_table_int_needs_growth(table->size - table->_has_zero_key, table->capacity)) {
+        if (table->capacity >= HASH_TABLE_MAX_CAPACITY || hash_table_u64_resize(table, table->capacity * 2) != 0) {
+            return 1;
+        }
+        index = hash_table_u64_find(table, key);
+    }
+
+    table->slots[index].key = key;
+    table->slots[index].value = value;
+    table->size++;
+    return 0;
+}
+
+uint64_t *hash_table_u64_get(hash_table_u64_t *table, uint64_t key) {
+    if (table == NULL) return NULL;
+
+    if (key == 0) {
+        return table->_has_zero_key ? &table->_zero_value : NULL;
+    }
+
+    size_t index = hash_table_u64_find(table, key);
+    return table->slots[index].key == key ? &table->slots[index].value : NULL;
+}
+
+char hash_table_u64_contains(hash_table_u64_t *table, uint64_t key) {
+    return hash_table_u64_get(table, key) != NULL;
+}
+
+void hash_table_u64_remove(hash_table_u64_t *table, uint64_t key) {
+    if (table == NULL) return;
+
+    if (key == 0) {
+        table->size -= table->_has_zero_key;
+        table->_has_zero_key = 0;
+        table->_zero_value = 0;
+        return;
+    }
+
+    size_t hole = hash_table_u64_find(table, key);
+    if (table->slots[hole].key != key) return;
+
+    // Backward-shift deletion: pull later entries of the cluster into the hole when
+    // the hole lies on their probe path
+    size_t next = (hole + 1) & table->_mask;
+    while (table->slots[next].key != 0) {
+        size_t home = hash_table_u64_home(table, table->slots[next].key);
+        if (((next - home) & table->_mask) >= ((next - hole) & table->_mask)) {
+            table->slots[hole] = table->slots[next];
+            hole = next;
+        }
+        next = (next + 1) & table->_mask;
+    }
+
+    table->slots[hole].key = 0;
+    table->slots[hole].value = 0;
+    table->size--;
+}
+
+size_t hash_table_u64_size(hash_table_u64_t *table) {
+    if (table == NULL) return 0;
+    return table->size;
+}
+
+size_t hash_table_u64_capacity(hash_table_u64_t *table) {
+    if (table == NULL) return 0;
+    return table->capacity;
+}
+
+void hash_table_u64_clear(hash_table_u64_t *table) {
+    if (table == NULL) return;
+    memset(table->slots, 0, table->capacity * sizeof(hash_table_u64_slot_t));
+    table->size = 0;
+    table->_has_zero_key = 0;
+    table->_zero_value = 0;
+}
+
+// ============================================================================
+// uint32_t Keys
+// ============================================================================
+
+static inline size_t hash_table_u32_home(const hash_table_u32_t *table, uint32_t key) {
+    return (size_t)hash_table_mix_u32(key) & table->_mask;
+}
+
+// Slot holding the key, or the empty slot that ends its probe sequence (key must not be 0)
+static inline size_t hash_table_u32_find(const hash_table_u32_t *table, uint32_t key) {
+    size_t index = hash_table_u32_home(table, key);
+    while (table->slots[index].key != key && table->slots[index].key != 0) {
+        index = (index + 1) & table->_mask;
+    }
+    return index;
+}
+
+// Allocate an empty slot array (all keys 0)
+// Returns 0 on success, 1 on failure (the table is unchanged)
+static int hash_table_u32_alloc_slots(hash_table_u32_t *table, size_t capacity) {
+    hash_table_u32_slot_t *slots = calloc(capacity, sizeof(hash_table_u32_slot_t));
+    if (slots == NULL) return 1;
+    table->slots = slots;
+    table->capacity = capacity;
+    table->_mask = capacity - 1;
+    return 0;
+}
+
+static int hash_table_u32_resize(hash_table_u32_t *table, size_t new_capacity) {
+    hash_table_u32_slot_t *old_slots = table->slots;
+    size_t old_capacity = table->capacity;
+
+    if (hash_table_u32_alloc_slots(table, new_capacity) != 0) {
+        fprintf(stderr, "Error: Failed to allocate memory for resized hash table.\n");
+        return 1;
+    }
+
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old_slots[i].key != 0) {
+            table->slots[hash_table_u32_find(table, old_slots[i].key)] = old_slots[i];
+        }
+    }
+
+    free(old_slots);
+    return 0;
+}
+
+hash_table_u32_t *hash_table_u32_create(void) {
+    return hash_table_u32_create_with_capacity(HASH_TABLE_DEFAULT_INITIAL_CAPACITY);
+}
+
+hash_table_u32_t *hash_table_u32_create_with_capacity(size_t capacity) {
+    capacity = hash_table_int_round_capacity(capacity);
+    if (capacity == 0) return NULL;
+    hash_table_u32_t *table = malloc(sizeof(hash_table_u32_t));
+    if (table == NULL) return NULL;
+    table->size = 0;
+    table->_has_zero_key = 0;
+    table->_zero_value = 0;
+    if (hash_table_u32_alloc_slots(table, capacity) != 0) {
+        free(table);
+        return NULL;
+    }
+    return table;
+}
+
+void hash_table_u32_destroy(hash_table_u32_t *table) {
+    if (table == NULL) return;
+    free(table->slots);
+    free(table);
+}
+
+int hash_table_u32_insert(hash_table_u32_t *table, uint32_t key, uint32_t value) {
+    if (table == NULL) return 1;
+
+    if (key == 0) {
+        table->size += !table->_has_zero_key;
+        table->_has_zero_key = 1;
+        table->_zero_value = value;
+        return 0;
+    }
+
+    size_t index = hash_table_u32_find(table, key);
+    if (table->slots[index].key == key) {
+        table->slots[index].value = value;
+        return 0;
+    }
+
+    if (hash_table_int_needs_growth(table->size - table->_has_zero_key, table->capacity)) {
+        if (table->capacity >= HASH_TABLE_MAX_CAPACITY || hash_table_u32_resize(table, table->capacity * 2) != 0) {
+            return 1;
+        }
+        index = hash_table_u32_find(table, key);
+    }
+
+    table->slots[index].key = key;
+    table->slots[index].value = value;
+    table->size++;
+    return 0;
+}
+
+uint32_t *hash_table_u32_get(hash_table_u32_t *table, uint32_t key) {
+    if (table == NULL) return NULL;
+
+    if (key == 0) {
+        return table->_has_zero_key ? &table->_zero_value : NULL;
+    }
+
+    size_t index = hash_table_u32_find(table, key);
+    return table->slots[index].key == key ? &table->slots[index].value : NULL;
+}
+
+char hash_table_u32_contains(hash_table_u32_t *table, uint32_t key) {
+    return hash_table_u32_get(table, key) != NULL;
+}
+
+void hash_table_u32_remove(hash_table_u32_t *table, uint32_t key) {
+    if (table == NULL) return;
+
+    if (key == 0) {
+        table->size -= table->_has_zero_key;
+        table->_has_zero_key = 0;
+        table->_zero_value = 0;
+        return;
+    }
+
+    size_t hole = hash_table_u32_find(table, key);
+    if (table->slots[hole].key != key) return;
+
+    // Backward-shift deletion, as for uint64_t keys
+    size_t next = (hole + 1) & table->_mask;
+    while (table->slots[next].key != 0) {
+        size_t home = hash_table_u32_home(table, table->slots[next].key);
+        if (((next - home) & table->_mask) >= ((next - hole) & table->_mask)) {
+            table->slots[hole] = table->slots[next];
+            hole = next;
+        }
+        next = (next + 1) & table->_mask;
+    }
+
+    table->slots[hole].key = 0;
+    table->slots[hole].value = 0;
+    table->size--;
+}
+
+size_t hash_table_u32_size(hash_table_u32_t *table) {
+    if (table == NULL) return 0;
+    return table->size;
+}
+
+size_t hash_table_u32_capacity(hash_table_u32_t *table) {
+    if (table == NULL) return 0;
+    return table->capacity;
+}
+
+void hash_table_u32_clear(hash_table_u32_t *table) {
+    if (table == NULL) return;
+    memset(table->slots, 0, table->capacity * sizeof(hash_table_u32_slot_t));
+    table->size = 0;
+    table->_has_zero_key = 0;
+    table->_zero_value = 0;
+}
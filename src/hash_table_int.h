@@ -0,0 +1,102 @@
+#pragma once
+
+#include <stddef.h>  // size_t
+#include <stdint.h>  // uint32_t, uint64_t
+
+// ============================================================================
+// Integer Key Tables
+// ============================================================================
+// Specialised tables for integer keys and integer values, for when the generic table's
+// key copies, key sizes and byte comparisons cost more than the lookup itself.
+//
+// - hash_table_u64_t maps uint64_t keys to uint64_t values (16-byte slots)
+// - hash_table_u32_t maps uint32_t keys to uint32_t values (8-byte slots)
+//
+// Each slot holds its key and value inline, and key 0 marks an empty slot, so a lookup
+// usually touches a single cache line and never dereferences anything else. Key 0 is
+// still a valid key: its entry is kept in the table struct instead of the slot array.
+// Keys are mixed with a MurmurHash3 finalizer, collisions are resolved with linear probing
+// and removes shift later entries back (no tombstones). Capacities are powers of two,
+// doubling past HASH_TABLE_DEFAULT_RESIZE_THRESHOLD.
+//
+// Values are plain integers (store pointers as uintptr_t), the table never frees anything.
+// Pointers returned by get are valid until the next insert, remove or clear.
+
+// One slot of a hash_table_u64_t (key 0 = empty)
+typedef struct hash_table_u64_slot {
+    uint64_t key;
+    uint64_t value;
+} hash_table_u64_slot_t;
+
+// uint64_t -> uint64_t hash table
+typedef struct hash_table_u64 {
+    size_t capacity;              // Number of slots (power of two)
+    hash_table_u64_slot_t *slots; // Array of slots
+    size_t size;                  // Number of entries, including key 0
+    size_t _mask;                 // capacity - 1
+    int _has_zero_key;            // Is key 0 in the table?
+    uint64_t _zero_value;         // Value of key 0
+} hash_table_u64_t;
+
+// One slot of a hash_table_u32_t (key 0 = empty)
+typedef struct hash_table_u32_slot {
+    uint32_t key;
+    uint32_t value;
+} hash_table_u32_slot_t;
+
+// uint32_t -> uint32_t hash table
+typedef struct hash_table_u32 {
+    size_t capacity;              // Number of slots (power of two)
+    hash_table_u32_slot_t *slots; // Array of slots
+    size_t size;                  // Number of entries, including key 0
+    size_t _mask;                 // capacity - 1
+    int _has_zero_key;            // Is key 0 in the table?
+    uint32_t _zero_value;         // Value of key 0
+} hash_table_u32_t;
+
+// Create a new table with the default initial capacity (16)
+// Returns NULL on allocation failure
+hash_table_u64_t *hash_table_u64_create(void);
+
+// Create a new table with at least the given number of slots (rounded up to a power of two)
+// Returns NULL on allocation failure or if capacity is above HASH_TABLE_MAX_CAPACITY
+hash_table_u64_t *hash_table_u64_create_with_capacity(size_t capacity);
+
+// Destroy the table and free its slots
+void hash_table_u64_destroy(hash_table_u64_t *table);
+
+// Insert a key-value pair, or update the value if the key exists
+// Returns 0 on success, 1 on failure (the table remains unchanged)
+int hash_table_u64_insert(hash_table_u64_t *table, uint64_t key, uint64_t value);
+
+// Get a pointer to the value of a key, or NULL if the key does not exist
+// The pointer is valid until the next insert, remove or clear
+uint64_t *hash_table_u64_get(hash_table_u64_t *table, uint64_t key);
+
+// Check if the table contains a key
+// Returns 1 if the key exists, 0 otherwise
+char hash_table_u64_contains(hash_table_u64_t *table, uint64_t key);
+
+// Remove a key, does nothing if the key does not exist
+void hash_table_u64_remove(hash_table_u64_t *table, uint64_t key);
+
+// Get the number of entries
+size_t hash_table_u64_size(hash_table_u64_t *table);
+
+// Get the number of slots
+size_t hash_table_u64_capacity(hash_table_u64_t *table);
+
+// Remove all entries (the capacity is kept)
+void hash_table_u64_clear(hash_table_u64_t *table);
+
+// uint32_t versions, same semantics as the uint64_t ones above
+hash_table_u32_t *hash_table_u32_create(void);
+hash_table_u32_t *hash_table_u32_create_with_capacity(size_t capacity);
+void hash_table_u32_destroy(hash_table_u32_t *table);
+int hash_table_u32_insert(hash_table_u32_t *table, uint32_t key, uint32_t value);
+uint32_t *hash_table_u32_get(hash_table_u32_t *table, uint32_t key);
+char hash_table_u32_contains(hash_table_u32_t *table, uint32_t key);
+void hash_table_u32_remove(hash_table_u32_t *table, uint32_t key);
+size_t hash_table_u32_size(hash_table_u32_t *table);
+size_t hash_table_u32_capacity(hash_table_u32_t *table);
+void hash_table_u32_clear(hash_table_u32_t *table);
@@ -0,0 +1,263 @@
+#pragma once
+
+#include "hash_table.h"
+#include "hash_table_group.h"
+#include "hash_table_hash.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// Type-Specialised Tables
+// ============================================================================
+// HT_DEFINE(name, key_t, val_t, hash_fn, eq_fn) generates a table type name_t and its
+// functions (name_create, name_insert, name_get, ...) for one key type and one value
+// type, all static inline. Keys and values are stored by value in the slots, and the
+// hash and equality functions are called directly, so the compiler can inline them
+// and constant-fold the key size instead of going through key_size, memcmp and
+// function pointers.
+//
+// - hash_fn: size_t hash_fn(key_t key), must hash equal keys equally
+// - eq_fn:   int eq_fn(key_t a, key_t b), non-zero if the keys are equal
+// Both can be functions or function-like macros (see HT_HASH_INT, HT_EQ_SCALAR, ...).
+//
+// The probing and resize policy is the one of hash_table_t with its default options:
+// - A control byte per slot holding 7 bits of the hash, scanned a group at a time
+//   (hash_table_group.h)
+// - Power-of-two capacities indexed with Fibonacci hashing
+// - Linear probing, growth past the resize threshold, backward-shift deletion
+//
+// The table never frees keys or values; with pointer keys or values, the caller owns
+// what they point to. Pointers returned by name_get are valid until the next insert,
+// remove or clear.
+//
+// Example:
+//     HT_DEFINE(id_map, uint64_t, double, HT_HASH_INT, HT_EQ_SCALAR)
+//
+//     id_map_t *map = id_map_create();
+//     id_map_insert(map, 42, 1.5);
+//     double *value = id_map_get(map, 42);
+//     id_map_destroy(map);
+
+// Hash for integer keys of up to 64 bits
+#define HT_HASH_INT(key) ((size_t)hash_table_mix_u64((uint64_t)(key)))
+
+// Equality for integer, pointer and other scalar keys
+#define HT_EQ_SCALAR(a, b) ((a) == (b))
+
+// Hash and equality for null-terminated string keys (const char *, not copied)
+#define HT_HASH_STR(key) hash_table_hash_wyhash((key), strlen(key), 0, NULL)
+#define HT_EQ_STR(a, b) (strcmp((a), (b)) == 0)
+
+// Hash and equality for trivially copyable keys without padding (structs, arrays)
+#define HT_HASH_BYTES(key) hash_table_hash_wyhash(&(key), sizeof(key), 0, NULL)
+#define HT_EQ_BYTES(a, b) (memcmp(&(a), &(b), sizeof(a)) == 0)
+
+#define HT_DEFINE(name, key_t, val_t, hash_fn, eq_fn) \
+\
+/* One slot: key and value side by side */ \
+typedef struct name##_slot { \
+    key_t key; \
+    val_t value; \
+} name##_slot_t; \
+\
+typedef struct name { \
+    size_t capacity;          /* Number of slots (power of two) */ \
+    uint8_t *ctrl;            /* Control bytes (capacity + HASH_TABLE_GROUP_WIDTH - 1, tail mirrors the start) */ \
+    name##_slot_t *slots;     /* Array of slots */ \
+    size_t size;              /* Number of entries */ \
+    size_t _mask;             /* capacity - 1 */ \
+    unsigned _hash_shift;     /* Shift applied after Fibonacci mixing */ \
+    float _resize_threshold;  /* Load factor that triggers a resize */ \
+    float _resize_factor;     /* Capacity multiplier on resize */ \
+} name##_t; \
+\
+static inline size_t name##_home(const name##_t *table, size_t hash) { \
+    return ((hash * HASH_TABLE_FIBONACCI_MULTIPLIER) >> table->_hash_shift) & table->_mask; \
+} \
+\
+static inline void name##_set_ctrl(name##_t *table, size_t index, uint8_t ctrl) { \
+    table->ctrl[index] = ctrl; \
+    for (size_t mirror = index; mirror < HASH_TABLE_GROUP_WIDTH - 1; mirror += table->capacity) { \
+        table->ctrl[table->capacity + mirror] = ctrl; \
+    } \
+} \
+\
+/* Allocate empty storage, overwriting the storage pointers; 0 on success, 1 on failure */ \
+static inline int name##_alloc_slots(name##_t *table, size_t capacity) { \
+    if (capacity > HASH_TABLE_MAX_CAPACITY || capacity > SIZE_MAX / sizeof(name##_slot_t)) return 1; \
+    unsigned bits = 0; \
+    while (((size_t)1 << bits) < capacity) { \
+        bits++; \
+    } \
+    table->ctrl = (uint8_t *)malloc(capacity + HASH_TABLE_GROUP_WIDTH - 1); \
+    table->slots = (name##_slot_t *)malloc(capacity * sizeof(name##_slot_t)); \
+    if (table->ctrl == NULL || table->slots == NULL) { \
+        free(table->ctrl); \
+        free(table->slots); \
+        return 1; \
+    } \
+    memset(table->ctrl, HASH_TABLE_CTRL_EMPTY, capacity + HASH_TABLE_GROUP_WIDTH - 1); \
+    table->capacity = capacity; \
+    table->_mask = capacity - 1; \
+    table->_hash_shift = (unsigned)(sizeof(size_t) * CHAR_BIT) - (bits > 0 ? bits : 1); \
+    return 0; \
+} \
+\
+/* Slot holding the key, or SIZE_MAX */ \
+static inline size_t name##_find(const name##_t *table, key_t key, size_t hash) { \
+    const uint8_t h2 = hash_table_h2(hash); \
+    size_t index = name##_home(table, hash); \
+    for (size_t probed = 0; probed < table->capacity; probed += HASH_TABLE_GROUP_WIDTH) { \
+        const uint8_t *group = table->ctrl + index; \
+        hash_table_mask_t empty = hash_table_group_match_empty(group); \
+        hash_table_mask_t match = hash_table_group_match(group, h2); \
+        if (empty != 0) { \
+            match &= (empty & (0u - empty)) - 1; \
+        } \
+        while (match != 0) { \
+            size_t slot = (index + hash_table_mask_first(match)) & table->_mask; \
+            if (eq_fn(table->slots[slot].key, key)) return slot; \
+            match &= match - 1; \
+        } \
+        if (empty != 0) break; \
+        index = (index + HASH_TABLE_GROUP_WIDTH) & table->_mask; \
+    } \
+    return SIZE_MAX; \
+} \
+\
+/* First empty slot in the probe sequence of a hash (the table must not be full) */ \
+static inline size_t name##_find_empty(const name##_t *table, size_t hash) { \
+    size_t index = name##_home(table, hash); \
+    for (;;) { \
+        hash_table_mask_t empty = hash_table_group_match_empty(table->ctrl + index); \
+        if (empty != 0) { \
+            return (index + hash_table_mask_first(empty)) & table->_mask; \
+        } \
+        index = (index + HASH_TABLE_GROUP_WIDTH) & table->_mask; \
+    } \
+} \
+\
+static inline int name##_resize(name##_t *table, size_t new_capacity) { \
+    name##_t old = *table; \
+    if (name##_alloc_slots(table, new_capacity) != 0) { \
+        *table = old; \
+        return 1; \
+    } \
+    for (size_t i = 0; i < old.capacity; i++) { \
+        if (hash_table_ctrl_is_full(old.ctrl[i])) { \
+            size_t hash = (size_t)hash_fn(old.slots[i].key); \
+            size_t index = name##_find_empty(table, hash); \
+            table->slots[index] = old.slots[i]; \
+            name##_set_ctrl(table, index, hash_table_h2(hash)); \
+        } \
+    } \
+    free(old.ctrl); \
+    free(old.slots); \
+    return 0; \
+} \
+\
+/* Create a table with at least capacity slots (rounded up to a power of two) */ \
+/* NULL on allocation failure or if the slots would not fit in a size_t */ \
+static inline name##_t *name##_create_with_parameters(size_t capacity, float resize_threshold, float resize_factor) { \
+    if (capacity > HASH_TABLE_MAX_CAPACITY) return NULL; \
+    name##_t *table = (name##_t *)malloc(sizeof(name##_t)); \
+    if (table == NULL) return NULL; \
+    size_t rounded = 1; \
+    while (rounded < capacity) { \
+        rounded <<= 1; \
+    } \
+    table->size = 0; \
+    table->_resize_threshold = resize_threshold; \
+    table->_resize_factor = resize_factor; \
+    if (name##_alloc_slots(table, rounded) != 0) { \
+        free(table); \
+        return NULL; \
+    } \
+    return table; \
+} \
+\
+static inline name##_t *name##_create(void) { \
+    return name##_create_with_parameters(HASH_TABLE_DEFAULT_INITIAL_CAPACITY, \
+        HASH_TABLE_DEFAULT_RESIZE_THRESHOLD, HASH_TABLE_DEFAULT_RESIZE_FACTOR); \
+} \
+\
+static inline void name##_destroy(name##_t *table) { \
+    if (table == NULL) return; \
+    free(table->ctrl); \
+    free(table->slots); \
+    free(table); \
+} \
+\
+/* Insert or update; 0 on success, 1 on failure (the table remains unchanged) */ \
+static inline int name##_insert(name##_t *table, key_t key, val_t value) { \
+    if (table == NULL) return 1; \
+    size_t hash = (size_t)hash_fn(key); \
+    size_t index = name##_find(table, key, hash); \
+    if (index != SIZE_MAX) { \
+        table->slots[index].value = value; \
+        return 0; \
+    } \
+    if ((float)(table->size + 1) / table->capacity > table->_resize_threshold) { \
+        double grown = (double)table->capacity * table->_resize_factor; \
+        if (table->capacity >= HASH_TABLE_MAX_CAPACITY || grown > (double)HASH_TABLE_MAX_CAPACITY) return 1; \
+        size_t new_capacity = table->capacity << 1; \
+        while (new_capacity < (size_t)grown) { \
+            new_capacity <<= 1; \
+        } \
+        if (name##_resize(table, new_capacity) != 0) return 1; \
+    } \
+    if (table->size >= table->capacity) return 1; \
+    index = name##_find_empty(table, hash); \
+    table->slots[index].key = key; \
+    table->slots[index].value = value; \
+    name##_set_ctrl(table, index, hash_table_h2(hash)); \
+    table->size++; \
+    return 0; \
+} \
+\
+/* Pointer to the value of a key, or NULL */ \
+static inline val_t *name##_get(name##_t *table, key_t key) { \
+    if (table == NULL) return NULL; \
+    size_t index = name##_find(table, key, (size_t)hash_fn(key)); \
+    return index != SIZE_MAX ? &table->slots[index].value : NULL; \
+} \
+\
+static inline char name##_contains(name##_t *table, key_t key) { \
+    return name##_get(table, key) != NULL; \
+} \
+\
+/* Remove a key (no-op if missing), shifting later entries of its cluster back */ \
+static inline void name##_remove(name##_t *table, key_t key) { \
+    if (table == NULL) return; \
+    size_t hole = name##_find(table, key, (size_t)hash_fn(key)); \
+    if (hole == SIZE_MAX) return; \
+    size_t next = (hole + 1) & table->_mask; \
+    while (next != hole && hash_table_ctrl_is_full(table->ctrl[next])) { \
+        size_t home = name##_home(table, (size_t)hash_fn(table->slots[next].key)); \
+        if (((next - home) & table->_mask) >= ((next - hole) & table->_mask)) { \
+            table->slots[hole] = table->slots[next]; \
+            name##_set_ctrl(table, hole, table->ctrl[next]); \
+            hole = next; \
+        } \
+        next = (next + 1) & table->_mask; \
+    } \
+    name##_set_ctrl(table, hole, HASH_TABLE_CTRL_EMPTY); \
+    table->size--; \
+} \
+\
+static inline size_t name##_size(name##_t *table) { \
+    return table != NULL ? table->size : 0; \
+} \
+\
+static inline size_t name##_capacity(name##_t *table) { \
+    return table != NULL ? table->capacity : 0; \
+} \
+\
+static inline void name##_clear(name##_t *table) { \
+    if (table == NULL) return; \
+    memset(table->ctrl, HASH_TABLE_CTRL_EMPTY, table->capacity + HASH_TABLE_GROUP_WIDTH - 1); \
+    table->size = 0; \
+}
@@ -1,6 +1,10 @@
 #include "test_framework.h"
 #include "../src/hash_table.h"
+#include "../src/hash_table_hash.h"
+#include "../src/hash_table_int.h"
+#include "../src/hash_table_typed.h"
 #include "../src/hash_table_util.h"
+#include <ctype.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -128,6 +132,105 @@ TEST(test_contains) {
     hash_table_destroy(table);
 }
 
+TEST(test_get_batch) {
+    for (int migrating = 0; migrating <= 1; migrating++) {
+        hash_table_options_t options = hash_table_default_options();
+        options.value_size = sizeof(int);
+        options.migration_batch = migrating ? 2 : 0;
+        hash_table_t *table = hash_table_create_with_options(&options);
+        
+        // Long keys are stored out of line, so the batch compares heap copies too
+        char names[100][40];
+        const void *keys[100];
+        size_t key_sizes[100];
+        void *values[100];
+        for (int i = 0; i < 100; i++) {
+            snprintf(names[i], sizeof(names[i]), i % 2 ? "batch_key_%d" : "a_much_longer_batch_key_%d", i);
+            keys[i] = names[i];
+            key_sizes[i] = strlen(names[i]) + 1;
+            if (i % 3 != 0) {
+                hash_table_insert_copy(table, keys[i], key_sizes[i], &i, sizeof(int));
+            }
+        }
+        if (migrating) {
+            while (table->_old == NULL) {
+                int key = 1000 + (int)hash_table_size(table);
+                hash_table_insert_copy(table, &key, sizeof(int), &key, sizeof(int));
+            }
+        }
+        keys[50] = NULL;
+        
+        size_t found = hash_table_get_batch(table, keys, key_sizes, 100, values);
+        size_t expected = 0;
+        for (int i = 0; i < 100; i++) {
+            if (i % 3 == 0 || i == 50) {
+                ASSERT_NULL(values[i], "Missing and NULL keys should get NULL");
+            } else {
+                ASSERT_NOT_NULL(values[i], "Present keys should be found");
+                ASSERT_EQ(i, *(int *)values[i], "Batch should return the value of each key");
+                expected++;
+            }
+        }
+        ASSERT_EQ(expected, found, "Batch should count the keys found");
+        ASSERT_EQ(0, hash_table_get_batch(table, keys, key_sizes, 0, values), "Empty batch should find nothing");
+        
+        hash_table_destroy(table);
+    }
+}
+
+TEST(test_insert_batch) {
+    for (int fixed = 0; fixed <= 1; fixed++) {
+        hash_table_options_t options = hash_table_default_options();
+        options.value_size = fixed ? sizeof(int) : 0;
+        hash_table_t *table = hash_table_create_with_options(&options);
+        int existing = -1;
+        int zero = 0;
+        hash_table_insert_copy(table, &zero, sizeof(int), &existing, sizeof(int));
+        
+        // Keys 0..999 plus a repeat of key 5 and a NULL key at the end
+        int ids[1002];
+        int data[1002];
+        const void *keys[1002];
+        size_t key_sizes[1002];
+        const void *values[1002];
+        int results[1002];
+        for (int i = 0; i < 1002; i++) {
+            ids[i] = i < 1000 ? i : 5;
+            data[i] = i;
+            keys[i] = &ids[i];
+            key_sizes[i] = sizeof(int);
+            values[i] = &data[i];
+        }
+        keys[1001] = NULL;
+        
+        ASSERT_EQ(1, hash_table_insert_batch(table, keys, key_sizes, values, sizeof(int), 1002, results),
+                  "Batch with a NULL key should report a failure");
+        for (int i = 0; i < 1001; i++) {
+            ASSERT_EQ(0, results[i], "Valid pairs should be inserted");
+        }
+        ASSERT_EQ(1, results[1001], "NULL key should fail");
+        ASSERT_EQ(1000, hash_table_size(table), "Existing and repeated keys should be updated, not added");
+        ASSERT_EQ(0, *(int *)hash_table_get(table, &zero, sizeof(int)), "Existing key should take the batch value");
+        int five = 5;
+        ASSERT_EQ(1000, *(int *)hash_table_get(table, &five, sizeof(int)), "Later duplicates should win");
+        for (int i = 6; i < 1000; i++) {
+            ASSERT_EQ(i, *(int *)hash_table_get(table, &ids[i], sizeof(int)), "Batch values should be found");
+        }
+        
+        ASSERT_EQ(0, hash_table_insert_batch(table, keys, key_sizes, values, sizeof(int), 1000, NULL),
+                  "Updating batch should succeed without results");
+        ASSERT_EQ(1000, hash_table_size(table), "Updating batch should not add keys");
+        
+        if (fixed) {
+            ASSERT_EQ(1, hash_table_insert_batch(table, keys, key_sizes, values, sizeof(short), 1, results),
+                      "Value size mismatch should fail");
+            ASSERT_EQ(1, results[0], "Mismatched pairs should fail");
+        }
+        
+        hash_table_destroy(table);
+    }
+}
+
 // ========================================
 // Remove Tests
 // ========================================
@@ -179,6 +282,135 @@ TEST(test_remove_multiple) {
     hash_table_destroy(table);
 }
 
+TEST(test_remove_keeps_probe_chains) {
+    // Nearly full table so keys are displaced past each other
+    hash_table_t *table = hash_table_create_with_parameters(8, 0.99, 2.0);
+    
+    for (int i = 0; i < 7; i++) {
+        int *value = malloc(sizeof(int));
+        *value = i;
+        char key[32];
+        snprintf(key, sizeof(key), "chain_%d", i);
+        hash_table_insert(table, key, strlen(key)+1, value);
+    }
+    ASSERT_EQ(8, hash_table_capacity(table), "Table should not have resized");
+    
+    // Removing any key must not hide keys displaced past it
+    for (int removed = 0; removed < 7; removed++) {
+        char key[32];
+        snprintf(key, sizeof(key), "chain_%d", removed);
+        hash_table_remove(table, key, strlen(key)+1);
+        
+        for (int i = removed + 1; i < 7; i++) {
+            snprintf(key, sizeof(key), "chain_%d", i);
+            int *retrieved = (int *)hash_table_get(table, key, strlen(key)+1);
+            ASSERT_NOT_NULL(retrieved, "Remaining keys should be found after remove");
+            ASSERT_EQ(i, *retrieved, "Remaining values should be correct after remove");
+        }
+    }
+    ASSERT_EQ(0, hash_table_size(table), "Size should be 0 after removing all keys");
+    
+    hash_table_destroy(table);
+}
+
+TEST(test_probe_across_groups) {
+    // Long clusters span several control groups and wrap around the end
+    hash_table_t *table = hash_table_create_with_parameters(100, 0.99, 2.0);
+    
+    for (int i = 0; i < 95; i++) {
+        int *value = malloc(sizeof(int));
+        *value = i;
+        hash_table_insert(table, &i, sizeof(int), value);
+    }
+    for (int i = 0; i < 95; i += 2) {
+        hash_table_remove(table, &i, sizeof(int));
+    }
+    for (int i = 100; i < 140; i++) {
+        int *value = malloc(sizeof(int));
+        *value = i;
+        hash_table_insert(table, &i, sizeof(int), value);
+    }
+    ASSERT_EQ(100, hash_table_capacity(table), "Table should not have resized");
+    
+    for (int i = 0; i < 140; i++) {
+        int *retrieved = (int *)hash_table_get(table, &i, sizeof(int));
+        if ((i < 95 && i % 2 == 0) || (i >= 95 && i < 100)) {
+            ASSERT_NULL(retrieved, "Removed or missing keys should not be found");
+        } else {
+            ASSERT_NOT_NULL(retrieved, "Inserted keys should be found");
+            ASSERT_EQ(i, *retrieved, "Values should be correct");
+        }
+    }
+    
+    hash_table_destroy(table);
+}
+
+TEST(test_remove_churn) {
+    // Session-table pattern: constant insert/remove churn in a nearly full table
+    hash_table_t *table = hash_table_create_with_parameters(64, 0.99, 2.0);
+    
+    for (int round = 0; round < 200; round++) {
+        for (int i = 0; i < 50; i++) {
+            int key = round * 50 + i;
+            hash_table_insert_copy(table, &key, sizeof(int), &key, sizeof(int));
+        }
+        for (int i = 0; i < 50; i++) {
+            int key = round * 50 + i;
+            int *retrieved = (int *)hash_table_get(table, &key, sizeof(int));
+            ASSERT_NOT_NULL(retrieved, "Keys should be found during churn");
+            ASSERT_EQ(key, *retrieved, "Values should be correct during churn");
+            hash_table_remove(table, &key, sizeof(int));
+        }
+    }
+    ASSERT_EQ(0, hash_table_size(table), "Size should be 0 after churn");
+    ASSERT_EQ(64, hash_table_capacity(table), "Churn should not grow the table");
+    
+    hash_table_destroy(table);
+}
+
+TEST(test_remove_from_full_table) {
+    // A threshold of 1.0 lets the table fill every slot, so the backward shift finds no empty slot
+    hash_table_probing_t probings[] = { HASH_TABLE_PROBING_LINEAR, HASH_TABLE_PROBING_ROBIN_HOOD };
+    for (size_t p = 0; p < 2; p++) {
+        hash_table_options_t options = hash_table_default_options();
+        options.initial_capacity = 16;
+        options.resize_threshold = 1.0f;
+        options.probing = probings[p];
+        hash_table_t *table = hash_table_create_with_options(&options);
+        for (int i = 0; i < 16; i++) {
+            hash_table_insert_copy(table, &i, sizeof(int), &i, sizeof(int));
+        }
+        ASSERT_EQ(16, hash_table_size(table), "Table should be full");
+        ASSERT_EQ(16, hash_table_capacity(table), "Table should not have grown");
+        
+        for (int i = 0; i < 16; i += 2) {
+            hash_table_remove(table, &i, sizeof(int));
+        }
+        ASSERT_EQ(8, hash_table_size(table), "Half the keys should remain");
+        for (int i = 0; i < 16; i++) {
+            int *retrieved = (int *)hash_table_get(table, &i, sizeof(int));
+            if (i % 2 == 0) {
+                ASSERT_NULL(retrieved, "Removed keys should be gone");
+            } else {
+                ASSERT_NOT_NULL(retrieved, "Remaining keys should be found");
+                ASSERT_EQ(i, *retrieved, "Values should be correct");
+            }
+        }
+        hash_table_destroy(table);
+    }
+    
+    // The default entry point reaches a full table too
+    hash_table_t *table = hash_table_create_with_parameters(16, 1.0f, 2.0f);
+    for (int i = 0; i < 16; i++) {
+        hash_table_insert_copy(table, &i, sizeof(int), &i, sizeof(int));
+    }
+    int key = 5;
+    hash_table_remove(table, &key, sizeof(int));
+    ASSERT_EQ(15, hash_table_size(table), "Remove from a full table should succeed");
+    ASSERT_NULL(hash_table_get(table, &key, sizeof(int)), "Removed key should be gone");
+    hash_table_destroy(table);
+}
+
 // ========================================
 // Clear Tests
 // ========================================
@@ -234,6 +466,885 @@ TEST(test_resize) {
     hash_table_destroy(table);
 }
 
+TEST(test_resize_long_keys) {
+    hash_table_t *table = hash_table_create_with_parameters(4, 0.75, 2.0);
+    
+    // Long keys that only differ at the end, resized several times
+    char key[512];
+    for (int i = 0; i < 100; i++) {
+        memset(key, 'k', sizeof(key));
+        snprintf(key + 480, sizeof(key) - 480, "_%d", i);
+        hash_table_insert_copy(table, key, sizeof(key), &i, sizeof(int));
+    }
+    ASSERT_EQ(100, hash_table_size(table), "All values should be inserted");
+    
+    for (int i = 0; i < 100; i++) {
+        memset(key, 'k', sizeof(key));
+        snprintf(key + 480, sizeof(key) - 480, "_%d", i);
+        int *retrieved = (int *)hash_table_get(table, key, sizeof(key));
+        ASSERT_NOT_NULL(retrieved, "Should retrieve long keys after resize");
+        ASSERT_EQ(i, *retrieved, "Values should be correct after resize");
+    }
+    
+    hash_table_destroy(table);
+}
+
+TEST(test_power_of_two_growth) {
+    // Power-of-two tables stay power-of-two even with a fractional factor
+    hash_table_t *table = hash_table_create_with_parameters(16, 0.5, 1.5);
+    for (int i = 0; i < 100; i++) {
+        hash_table_insert_copy(table, &i, sizeof(int), &i, sizeof(int));
+        size_t capacity = hash_table_capacity(table);
+        ASSERT_EQ(0, capacity & (capacity - 1), "Capacity should stay a power of two");
+    }
+    ASSERT_EQ(256, hash_table_capacity(table), "Capacity should round up to powers of two");
+    hash_table_destroy(table);
+    
+    // Other capacities keep modulo indexing and the exact resize factor
+    table = hash_table_create_with_parameters(10, 0.5, 3.0);
+    for (int i = 0; i < 100; i++) {
+        hash_table_insert_copy(table, &i, sizeof(int), &i, sizeof(int));
+    }
+    ASSERT_EQ(270, hash_table_capacity(table), "Odd capacities should grow by the exact factor");
+    for (int i = 0; i < 100; i++) {
+        int *retrieved = (int *)hash_table_get(table, &i, sizeof(int));
+        ASSERT_NOT_NULL(retrieved, "Should retrieve values with modulo indexing");
+        ASSERT_EQ(i, *retrieved, "Values should be correct with modulo indexing");
+    }
+    hash_table_destroy(table);
+}
+
+TEST(test_reserve) {
+    hash_table_t *table = hash_table_create();
+    ASSERT_EQ(0, hash_table_reserve(table, 10000), "Reserve should succeed");
+    size_t capacity = hash_table_capacity(table);
+    ASSERT_EQ(32768, capacity, "Reserve should size for n entries at the threshold, rounded to a power of two");
+    
+    for (int i = 0; i < 10000; i++) {
+        hash_table_insert_copy(table, &i, sizeof(int), &i, sizeof(int));
+    }
+    ASSERT_EQ(capacity, hash_table_capacity(table), "Reserved entries should not trigger a resize");
+    
+    // Reserving less than the current capacity is a no-op
+    ASSERT_EQ(0, hash_table_reserve(table, 10), "Smaller reserve should succeed");
+    ASSERT_EQ(capacity, hash_table_capacity(table), "Reserve should never shrink");
+    
+    // Sizes whose capacity does not fit in a size_t fail without touching the table
+    ASSERT_EQ(1, hash_table_reserve(table, SIZE_MAX), "Unrepresentable reserve should fail");
+    ASSERT_EQ(1, hash_table_reserve(table, (SIZE_MAX >> 1) + 1), "Unrepresentable reserve should fail");
+    ASSERT_EQ(capacity, hash_table_capacity(table), "Failed reserve should leave the capacity");
+    ASSERT_EQ(10000, hash_table_size(table), "Failed reserve should leave the entries");
+    hash_table_destroy(table);
+    
+    // Other capacities get the exact size
+    table = hash_table_create_with_parameters(10, 0.5, 2.0);
+    hash_table_reserve(table, 100);
+    ASSERT_EQ(200, hash_table_capacity(table), "Odd capacities should reserve exactly");
+    for (int i = 0; i < 100; i++) {
+        hash_table_insert_copy(table, &i, sizeof(int), &i, sizeof(int));
+    }
+    ASSERT_EQ(200, hash_table_capacity(table), "Reserved entries should not trigger a resize");
+    
+    ASSERT_EQ(1, hash_table_reserve(NULL, 10), "Reserve on NULL should fail");
+    hash_table_destroy(table);
+}
+
+TEST(test_shrink_to_fit) {
+    hash_table_t *table = hash_table_create();
+    for (int i = 0; i < 10000; i++) {
+        hash_table_insert_copy(table, &i, sizeof(int), &i, sizeof(int));
+    }
+    for (int i = 100; i < 10000; i++) {
+        hash_table_remove(table, &i, sizeof(int));
+    }
+    ASSERT_EQ(0, hash_table_shrink_to_fit(table), "Shrink should succeed");
+    ASSERT_EQ(256, hash_table_capacity(table), "Shrink should size for the remaining entries");
+    for (int i = 0; i < 100; i++) {
+        int *retrieved = (int *)hash_table_get(table, &i, sizeof(int));
+        ASSERT_NOT_NULL(retrieved, "Should retrieve values after shrinking");
+        ASSERT_EQ(i, *retrieved, "Values should be correct after shrinking");
+    }
+    ASSERT_NULL(hash_table_get(table, &(int){100}, sizeof(int)), "Removed keys should stay removed");
+    
+    // An empty table shrinks to a single slot and can still grow again
+    hash_table_clear(table);
+    hash_table_shrink_to_fit(table);
+    ASSERT_EQ(1, hash_table_capacity(table), "Empty table should shrink to one slot");
+    for (int i = 0; i < 50; i++) {
+        hash_table_insert_copy(table, &i, sizeof(int), &i, sizeof(int));
+    }
+    ASSERT_EQ(50, hash_table_size(table), "Shrunk table should grow again");
+    ASSERT_EQ(49, *(int *)hash_table_get(table, &(int){49}, sizeof(int)), "Values should be correct after growing");
+    
+    ASSERT_EQ(1, hash_table_shrink_to_fit(NULL), "Shrink on NULL should fail");
+    hash_table_destroy(table);
+}
+
+TEST(test_shrink_on_low_load) {
+    hash_table_options_t options = hash_table_default_options();
+    options.shrink_threshold = HASH_TABLE_DEFAULT_SHRINK_THRESHOLD;
+    hash_table_t *table = hash_table_create_with_options(&options);
+    for (int i = 0; i < 10000; i++) {
+        hash_table_insert_copy(table, &i, sizeof(int), &i, sizeof(int));
+    }
+    ASSERT_EQ(32768, hash_table_capacity(table), "Table should grow as usual");
+    
+    for (int i = 100; i < 10000; i++) {
+        hash_table_remove(table, &i, sizeof(int));
+    }
+    ASSERT_EQ(512, hash_table_capacity(table), "Removes should halve the capacity below 1/8 load");
+    for (int i = 0; i < 100; i++) {
+        int *retrieved = (int *)hash_table_get(table, &i, sizeof(int));
+        ASSERT_NOT_NULL(retrieved, "Should retrieve values after shrinking");
+        ASSERT_EQ(i, *retrieved, "Values should be correct after shrinking");
+    }
+    
+    // Right after a shrink, alternating inserts and removes must not resize again
+    int key = 99;
+    while (hash_table_capacity(table) == 512) {
+        hash_table_remove(table, &key, sizeof(int));
+        key--;
+    }
+    size_t capacity = hash_table_capacity(table);
+    for (int i = 0; i < 1000; i++) {
+        hash_table_insert_copy(table, &key, sizeof(int), &key, sizeof(int));
+        hash_table_remove(table, &key, sizeof(int));
+        ASSERT_EQ(capacity, hash_table_capacity(table), "Capacity should not thrash at the shrink boundary");
+    }
+    
+    // Clear goes back to the initial capacity
+    hash_table_clear(table);
+    ASSERT_EQ(HASH_TABLE_DEFAULT_INITIAL_CAPACITY, hash_table_capacity(table), "Clear should release the peak capacity");
+    
+    // Removes never shrink below the initial capacity
+    for (int i = 0; i < 5; i++) {
+        hash_table_insert_copy(table, &i, sizeof(int), &i, sizeof(int));
+    }
+    for (int i = 0; i < 5; i++) {
+        hash_table_remove(table, &i, sizeof(int));
+    }
+    ASSERT_EQ(HASH_TABLE_DEFAULT_INITIAL_CAPACITY, hash_table_capacity(table), "Capacity should not drop below the initial capacity");
+    hash_table_destroy(table);
+}
+
+TEST(test_incremental_resize) {
+    hash_table_options_t options = hash_table_default_options();
+    options.migration_batch = 4;
+    hash_table_t *table = hash_table_create_with_options(&options);
+    
+    int saw_migration = 0;
+    for (int i = 0; i < 4000; i++) {
+        hash_table_insert_copy(table, &i, sizeof(int), &i, sizeof(int));
+        if (table->_old != NULL) {
+            saw_migration = 1;
+            ASSERT(table->_old->size <= table->size, "Old storage should only hold part of the entries");
+        }
+        // Every key inserted so far must be found, whichever storage it is in
+        if (i % 97 == 0) {
+            for (int j = 0; j <= i; j++) {
+                int *retrieved = (int *)hash_table_get(table, &j, sizeof(int));
+                ASSERT_NOT_NULL(retrieved, "Keys should be found during migration");
+                ASSERT_EQ(j, *retrieved, "Values should be correct");
+            }
+        }
+    }
+    ASSERT(saw_migration, "Growing should migrate incrementally");
+    ASSERT_EQ(4000, hash_table_size(table), "Size should count both storages");
+    
+    // Removes and updates reach entries that have not been migrated yet
+    while (table->_old == NULL) {
+        int key = (int)hash_table_size(table);
+        hash_table_insert_copy(table, &key, sizeof(int), &key, sizeof(int));
+    }
+    size_t size = hash_table_size(table);
+    for (int i = 0; i < 100; i++) {
+        hash_table_remove(table, &i, sizeof(int));
+        int updated = -i;
+        hash_table_insert_copy(table, &i, sizeof(int), &updated, sizeof(int));
+    }
+    ASSERT_EQ(size, hash_table_size(table), "Remove and re-insert should keep the size");
+    for (int i = 0; i < 100; i++) {
+        ASSERT_EQ(-i, *(int *)hash_table_get(table, &i, sizeof(int)), "Updated values should be found");
+    }
+    
+    // Clearing mid-migration drops both storages
+    hash_table_clear(table);
+    ASSERT_NULL(table->_old, "Clear should drop the old storage");
+    ASSERT_EQ(0, hash_table_size(table), "Clear should empty the table");
+    
+    hash_table_destroy(table);
+}
+
+// ========================================
+// Iteration Tests
+// ========================================
+
+TEST(test_iterator) {
+    hash_table_options_t options = hash_table_default_options();
+    options.value_size = sizeof(int);
+    options.migration_batch = 4;
+    hash_table_t *table = hash_table_create_with_options(&options);
+    
+    hash_table_iter_t iter;
+    hash_table_iter_init(&iter, table);
+    ASSERT_EQ(0, hash_table_iter_next(&iter), "Empty table should have nothing to iterate");
+    
+    // Stop in the middle of a migration so both storages hold entries
+    int count = 0;
+    while (table->_old == NULL || count < 100) {
+        hash_table_insert_copy(table, &count, sizeof(int), &count, sizeof(int));
+        count++;
+    }
+    ASSERT_NOT_NULL(table->_old, "Table should be migrating");
+    
+    char seen[4096] = {0};
+    size_t visited = 0;
+    hash_table_iter_init(&iter, table);
+    while (hash_table_iter_next(&iter)) {
+        int key;
+        memcpy(&key, iter.key, sizeof(int));
+        ASSERT_EQ(sizeof(int), iter.key_size, "Iterator should report the key size");
+        ASSERT_EQ(key, *(int *)iter.value, "Iterator should report the value of its key");
+        ASSERT(key >= 0 && key < count && !seen[key], "Each key should be visited once");
+        seen[key] = 1;
+        visited++;
+    }
+    ASSERT_EQ(hash_table_size(table), visited, "Iterator should visit every entry");
+    
+    hash_table_destroy(table);
+}
+
+// Does every bit of the occupancy bitmap match the control byte of its slot?
+static int occupancy_matches_ctrl(const hash_table_t *table) {
+    for (size_t i = 0; i < table->capacity; i++) {
+        int bit = (int)((table->occupied[i / 64] >> (i % 64)) & 1);
+        if (bit != hash_table_ctrl_is_full(table->ctrl[i])) return 0;
+    }
+    return 1;
+}
+
+TEST(test_occupancy_bitmap) {
+    for (int tombstones = 0; tombstones <= 1; tombstones++) {
+        hash_table_options_t options = hash_table_default_options();
+        options.value_size = sizeof(int);
+        options.deletion = tombstones ? HASH_TABLE_DELETION_TOMBSTONE : HASH_TABLE_DELETION_BACKWARD_SHIFT;
+        hash_table_t *table = hash_table_create_with_options(&options);
+        
+        for (int i = 0; i < 5000; i++) {
+            hash_table_insert_copy(table, &i, sizeof(int), &i, sizeof(int));
+        }
+        // Leave a sparse table behind: every 50th key survives
+        for (int i = 0; i < 5000; i++) {
+            if (i % 50 != 0) {
+                hash_table_remove(table, &i, sizeof(int));
+            }
+        }
+        ASSERT(occupancy_matches_ctrl(table), "Bitmap should track inserts and removes");
+        
+        size_t visited = 0;
+        hash_table_iter_t iter;
+        hash_table_iter_init(&iter, table);
+        while (hash_table_iter_next(&iter)) {
+            int key;
+            memcpy(&key, iter.key, sizeof(int));
+            ASSERT_EQ(0, key % 50, "Iterator should only visit the remaining keys");
+            visited++;
+        }
+        ASSERT_EQ(100, visited, "Iterator should visit every remaining key");
+        
+        hash_table_clear(table);
+        ASSERT(occupancy_matches_ctrl(table), "Clear should reset the bitmap");
+        for (size_t i = 0; i < table->capacity; i++) {
+            ASSERT_EQ(HASH_TABLE_CTRL_EMPTY, table->ctrl[i], "Clear should empty every slot");
+        }
+        int key = 7;
+        hash_table_insert_copy(table, &key, sizeof(int), &key, sizeof(int));
+        ASSERT_EQ(7, *(int *)hash_table_get(table, &key, sizeof(int)), "Table should be usable after clear");
+        
+        hash_table_destroy(table);
+    }
+}
+
+static void scan_mark(const void *key, size_t key_size, void *value, void *context) {
+    (void)key_size;
+    (void)value;
+    int id;
+    memcpy(&id, key, sizeof(int));
+    ((char *)context)[id] = 1;
+}
+
+TEST(test_scan_across_resize) {
+    hash_table_t *table = hash_table_create();
+    char seen[8000] = {0};
+    
+    // Keys below 1000 stay for the whole scan, the rest come and go between calls
+    for (int i = 0; i < 1000; i++) {
+        hash_table_insert_copy(table, &i, sizeof(int), &i, sizeof(int));
+    }
+    size_t cursor = 0;
+    int calls = 0;
+    do {
+        cursor = hash_table_scan(table, cursor, 16, scan_mark, seen);
+        calls++;
+        // Grow for the first half of the scan, then shrink back
+        for (int i = 0; i < 50; i++) {
+            int key = 1000 + calls * 50 + i;
+            if (calls < 40 && key < 8000) {
+                hash_table_insert_copy(table, &key, sizeof(int), &key, sizeof(int));
+            } else if (calls >= 40) {
+                key -= 40 * 50;
+                hash_table_remove(table, &key, sizeof(int));
+            }
+        }
+        if (calls == 60) {
+            hash_table_shrink_to_fit(table);
+        }
+    } while (cursor != 0 && calls < 100000);
+    
+    ASSERT(calls > 1, "Scan should take several calls");
+    for (int i = 0; i < 1000; i++) {
+        ASSERT(seen[i], "Scan should visit every key present for the whole scan");
+    }
+    
+    // Without modifications, a scan visits exactly the entries of the table
+    memset(seen, 0, sizeof(seen));
+    size_t size = hash_table_size(table);
+    cursor = 0;
+    do {
+        cursor = hash_table_scan(table, cursor, 100, scan_mark, seen);
+    } while (cursor != 0);
+    size_t visited = 0;
+    for (int i = 0; i < 8000; i++) {
+        visited += seen[i];
+    }
+    ASSERT_EQ(size, visited, "Scan should visit every entry");
+    
+    hash_table_destroy(table);
+}
+
+// ========================================
+// Options Tests
+// ========================================
+
+TEST(test_create_with_options) {
+    hash_table_options_t options = hash_table_default_options();
+    ASSERT_EQ(HASH_TABLE_DEFAULT_INITIAL_CAPACITY, options.initial_capacity, "Default options should use default capacity");
+    ASSERT_EQ(HASH_TABLE_LAYOUT_SPLIT, options.layout, "Default options should use split layout");
+    
+    options.initial_capacity = 64;
+    hash_table_t *table = hash_table_create_with_options(&options);
+    ASSERT_NOT_NULL(table, "Table should be created");
+    ASSERT_EQ(64, hash_table_capacity(table), "Table should use capacity from options");
+    ASSERT_NULL(hash_table_create_with_options(NULL), "NULL options should fail");
+    
+    hash_table_destroy(table);
+}
+
+TEST(test_interleaved_layout) {
+    hash_table_options_t options = hash_table_default_options();
+    options.layout = HASH_TABLE_LAYOUT_INTERLEAVED;
+    options.initial_capacity = 4;
+    hash_table_t *table = hash_table_create_with_options(&options);
+    ASSERT_NOT_NULL(table, "Table should be created");
+    
+    // Enough entries to resize several times
+    for (int i = 0; i < 200; i++) {
+        char key[32];
+        snprintf(key, sizeof(key), "key_%d", i);
+        hash_table_insert_copy(table, key, strlen(key)+1, &i, sizeof(int));
+    }
+    ASSERT_EQ(200, hash_table_size(table), "All values should be inserted");
+    
+    int updated = -1;
+    hash_table_insert_copy(table, SKEY("key_7"), &updated, sizeof(int));
+    for (int i = 0; i < 200; i += 3) {
+        char key[32];
+        snprintf(key, sizeof(key), "key_%d", i);
+        hash_table_remove(table, key, strlen(key)+1);
+    }
+    
+    for (int i = 0; i < 200; i++) {
+        char key[32];
+        snprintf(key, sizeof(key), "key_%d", i);
+        int *retrieved = (int *)hash_table_get(table, key, strlen(key)+1);
+        if (i % 3 == 0) {
+            ASSERT_NULL(retrieved, "Removed keys should not exist");
+        } else {
+            ASSERT_NOT_NULL(retrieved, "Remaining keys should exist");
+            ASSERT_EQ(i == 7 ? -1 : i, *retrieved, "Values should be correct");
+        }
+    }
+    
+    hash_table_clear(table);
+    ASSERT_EQ(0, hash_table_size(table), "Size should be 0 after clear");
+    ASSERT_NULL(hash_table_get(table, SKEY("key_1")), "Keys should not exist after clear");
+    
+    hash_table_destroy(table);
+}
+
+TEST(test_fixed_value_size) {
+    for (int layout = 0; layout < 2; layout++) {
+        hash_table_options_t options = hash_table_default_options();
+        options.layout = layout ? HASH_TABLE_LAYOUT_INTERLEAVED : HASH_TABLE_LAYOUT_SPLIT;
+        options.initial_capacity = 4;
+        options.value_size = sizeof(int);
+        hash_table_t *table = hash_table_create_with_options(&options);
+        ASSERT_NOT_NULL(table, "Table should be created");
+        
+        for (int i = 0; i < 100; i++) {
+            ASSERT_EQ(0, hash_table_insert_copy(table, &i, sizeof(int), &i, sizeof(int)), "Insert copy should succeed");
+        }
+        long wrong_size = 0;
+        ASSERT_EQ(1, hash_table_insert_copy(table, SKEY("wrong"), &wrong_size, sizeof(long)), "Mismatched value size should fail");
+        
+        // Move semantics still take ownership of the buffer
+        int key = 5;
+        int *moved = malloc(sizeof(int));
+        *moved = 500;
+        ASSERT_EQ(0, hash_table_insert(table, &key, sizeof(int), moved), "Insert should succeed");
+        
+        // Emplace returns the inline storage, zero-filled for new keys
+        int *slot = (int *)hash_table_emplace(table, SKEY("emplaced"));
+        ASSERT_NOT_NULL(slot, "Emplace should return value storage");
+        ASSERT_EQ(0, *slot, "New emplaced value should be zero");
+        *slot = 77;
+        key = 6;
+        slot = (int *)hash_table_emplace(table, &key, sizeof(int));
+        ASSERT_EQ(6, *slot, "Emplace should not reset existing values");
+        ASSERT_EQ(101, hash_table_size(table), "Size should count emplaced key once");
+        
+        for (int i = 0; i < 100; i += 2) {
+            hash_table_remove(table, &i, sizeof(int));
+        }
+        for (int i = 1; i < 100; i += 2) {
+            int *retrieved = (int *)hash_table_get(table, &i, sizeof(int));
+            ASSERT_NOT_NULL(retrieved, "Inline values should be found");
+            ASSERT_EQ(i == 5 ? 500 : i, *retrieved, "Inline values should survive resize and removes");
+        }
+        int *emplaced = (int *)hash_table_get(table, SKEY("emplaced"));
+        ASSERT_NOT_NULL(emplaced, "Emplaced key should be found");
+        ASSERT_EQ(77, *emplaced, "Value written through emplace should persist");
+        
+        hash_table_destroy(table);
+    }
+    
+    // Pointer value tables have no inline storage to emplace into
+    hash_table_t *table = hash_table_create();
+    ASSERT_NULL(hash_table_emplace(table, SKEY("key")), "Emplace needs fixed value size mode");
+    hash_table_destroy(table);
+}
+
+TEST(test_robin_hood_probing) {
+    // High load, both layouts, pointer and inline values
+    for (int variant = 0; variant < 4; variant++) {
+        hash_table_options_t options = hash_table_default_options();
+        options.probing = HASH_TABLE_PROBING_ROBIN_HOOD;
+        options.resize_threshold = HASH_TABLE_ROBIN_HOOD_RESIZE_THRESHOLD;
+        options.layout = (variant & 1) ? HASH_TABLE_LAYOUT_INTERLEAVED : HASH_TABLE_LAYOUT_SPLIT;
+        options.value_size = (variant & 2) ? sizeof(int) : 0;
+        hash_table_t *table = hash_table_create_with_options(&options);
+        ASSERT_NOT_NULL(table, "Table should be created");
+        
+        for (int i = 0; i < 5000; i++) {
+            ASSERT_EQ(0, hash_table_insert_copy(table, &i, sizeof(int), &i, sizeof(int)), "Insert should succeed");
+        }
+        ASSERT_EQ(5000, hash_table_size(table), "All values should be inserted");
+        ASSERT(hash_table_size(table) > hash_table_capacity(table) / 2, "Table should run above half load");
+        
+        for (int i = 0; i < 5000; i += 2) {
+            hash_table_remove(table, &i, sizeof(int));
+        }
+        ASSERT_EQ(2500, hash_table_size(table), "Half the values should be removed");
+        
+        for (int i = 0; i < 10000; i++) {
+            int *retrieved = (int *)hash_table_get(table, &i, sizeof(int));
+            if (i < 5000 && i % 2 == 1) {
+                ASSERT_NOT_NULL(retrieved, "Remaining keys should be found");
+                ASSERT_EQ(i, *retrieved, "Values should be correct");
+            } else {
+                ASSERT_NULL(retrieved, "Removed and missing keys should not be found");
+            }
+        }
+        
+        hash_table_destroy(table);
+    }
+}
+
+TEST(test_tombstone_deletion) {
+    hash_table_options_t options = hash_table_default_options();
+    options.deletion = HASH_TABLE_DELETION_TOMBSTONE;
+    options.initial_capacity = 64;
+    options.resize_threshold = 0.9f;
+    hash_table_t *table = hash_table_create_with_options(&options);
+    
+    for (int i = 0; i < 50; i++) {
+        hash_table_insert_copy(table, &i, sizeof(int), &i, sizeof(int));
+    }
+    
+    // Burst of deletes: tombstones pile up until the in-place cleanup kicks in
+    size_t max_tombstones = 0;
+    for (int i = 0; i < 40; i++) {
+        hash_table_remove(table, &i, sizeof(int));
+        if (table->_tombstones > max_tombstones) max_tombstones = table->_tombstones;
+    }
+    ASSERT(max_tombstones > 0, "Removes should leave tombstones");
+    ASSERT(max_tombstones <= 16, "Tombstones should be cleaned up past the threshold");
+    ASSERT_EQ(64, hash_table_capacity(table), "Cleanup should not grow the table");
+    ASSERT_EQ(10, hash_table_size(table), "Size should count live entries only");
+    
+    // Churn reuses tombstones and cleans up instead of growing
+    for (int i = 100; i < 2000; i++) {
+        hash_table_insert_copy(table, &i, sizeof(int), &i, sizeof(int));
+        int old = i - 40;
+        hash_table_remove(table, &old, sizeof(int));
+    }
+    ASSERT_EQ(64, hash_table_capacity(table), "Churn should not grow the table");
+    for (int i = 40; i < 2000; i++) {
+        int *retrieved = (int *)hash_table_get(table, &i, sizeof(int));
+        if ((i < 50) || (i >= 1960)) {
+            ASSERT_NOT_NULL(retrieved, "Live keys should be found");
+            ASSERT_EQ(i, *retrieved, "Values should be correct");
+        } else {
+            ASSERT_NULL(retrieved, "Removed keys should not be found");
+        }
+    }
+    
+    hash_table_destroy(table);
+}
+
+// Counting allocator: tracks live blocks and can be told to fail after a number of allocations
+typedef struct {
+    size_t allocations;
+    size_t releases;
+    size_t fail_after; // 0 = never fail
+} test_allocator_stats_t;
+
+static void *counting_allocate(size_t size, void *context) {
+    test_allocator_stats_t *stats = context;
+    if (stats->fail_after != 0 && stats->allocations >= stats->fail_after) return NULL;
+    stats->allocations++;
+    return malloc(size);
+}
+
+static void counting_release(void *ptr, void *context) {
+    test_allocator_stats_t *stats = context;
+    stats->releases++;
+    free(ptr);
+}
+
+TEST(test_custom_allocator) {
+    test_allocator_stats_t stats = { 0, 0, 0 };
+    hash_table_allocator_t allocator = { counting_allocate, counting_release, &stats };
+    
+    hash_table_t *table = hash_table_create_with_allocator(&allocator);
+    ASSERT_NOT_NULL(table, "Table creation should succeed");
+    ASSERT(stats.allocations > 0, "The table should be allocated through the allocator");
+    
+    char key[64];
+    memset(key, 'k', sizeof(key));
+    for (int i = 0; i < 1000; i++) {
+        memcpy(key, &i, sizeof(int));
+        hash_table_insert_copy(table, key, sizeof(key), &i, sizeof(int));
+    }
+    // Values passed to insert() are released with the allocator too
+    int *moved = counting_allocate(sizeof(int), &stats);
+    *moved = -1;
+    hash_table_insert_string(table, "moved", moved);
+    for (int i = 0; i < 500; i++) {
+        memcpy(key, &i, sizeof(int));
+        hash_table_remove(table, key, sizeof(key));
+    }
+    hash_table_clear(table);
+    hash_table_destroy(table);
+    ASSERT_EQ(stats.allocations, stats.releases, "Every allocation should be released through the allocator");
+    
+    // Same with the key arena, fixed size values and incremental resize
+    hash_table_options_t options = hash_table_default_options();
+    options.allocator = &allocator;
+    options.key_arena_chunk_size = 1024;
+    options.value_size = sizeof(int);
+    options.migration_batch = 8;
+    table = hash_table_create_with_options(&options);
+    for (int i = 0; i < 1000; i++) {
+        memcpy(key, &i, sizeof(int));
+        hash_table_insert_copy(table, key, sizeof(key), &i, sizeof(int));
+    }
+    hash_table_destroy(table);
+    ASSERT_EQ(stats.allocations, stats.releases, "Every allocation should be released through the allocator");
+    
+    // Failed allocations leave the table unchanged
+    table = hash_table_create_with_allocator(&allocator);
+    stats.fail_after = stats.allocations;
+    int value = 7;
+    ASSERT_EQ(1, hash_table_insert_copy(table, key, sizeof(key), &value, sizeof(int)), "Insert should fail when the allocator fails");
+    ASSERT_EQ(0, hash_table_size(table), "Failed insert should leave the table unchanged");
+    stats.fail_after = 0;
+    ASSERT_EQ(0, hash_table_insert_copy(table, key, sizeof(key), &value, sizeof(int)), "Insert should succeed again");
+    hash_table_destroy(table);
+    ASSERT_EQ(stats.allocations, stats.releases, "Every allocation should be released through the allocator");
+}
+
+TEST(test_huge_pages) {
+    for (int robin_hood = 0; robin_hood <= 1; robin_hood++) {
+        hash_table_options_t options = hash_table_default_options();
+        options.huge_pages = 1;
+        options.value_size = sizeof(uint64_t);
+        if (robin_hood) {
+            options.probing = HASH_TABLE_PROBING_ROBIN_HOOD;
+            options.resize_threshold = HASH_TABLE_ROBIN_HOOD_RESIZE_THRESHOLD;
+        }
+        hash_table_t *table = hash_table_create_with_options(&options);
+        ASSERT_EQ(0, table->_slots_mapped, "Small tables should not be mapped");
+        
+        // Grows past the mapping threshold, then by mremap (linear) or rebuilding (Robin Hood)
+        for (uint64_t i = 0; i < 200000; i++) {
+            hash_table_insert_copy(table, &i, sizeof(uint64_t), &i, sizeof(uint64_t));
+        }
+        ASSERT_EQ(1, table->_slots_mapped, "Large tables should be mapped");
+        for (uint64_t i = 0; i < 200000; i++) {
+            uint64_t *retrieved = (uint64_t *)hash_table_get(table, &i, sizeof(uint64_t));
+            ASSERT_NOT_NULL(retrieved, "Should retrieve values from mapped storage");
+            ASSERT(*retrieved == i, "Values should be correct in mapped storage");
+        }
+        
+        for (uint64_t i = 0; i < 200000; i += 2) {
+            hash_table_remove(table, &i, sizeof(uint64_t));
+        }
+        hash_table_shrink_to_fit(table);
+        ASSERT_EQ(100000, hash_table_size(table), "Size should be correct after shrinking");
+        for (uint64_t i = 1; i < 200000; i += 2) {
+            uint64_t *retrieved = (uint64_t *)hash_table_get(table, &i, sizeof(uint64_t));
+            ASSERT_NOT_NULL(retrieved, "Should retrieve values after shrinking");
+            ASSERT(*retrieved == i, "Values should be correct after shrinking");
+        }
+        hash_table_destroy(table);
+    }
+}
+
+// ========================================
+// Hash Function Tests
+// ========================================
+
+TEST(test_builtin_hashers) {
+    hash_function_t hashers[] = { hash_table_hash_fnv_1a, hash_table_hash_wyhash, hash_table_hash_crc32c, hash_table_hash_siphash };
+    unsigned char buffer[128];
+    for (size_t i = 0; i < sizeof(buffer); i++) {
+        buffer[i] = (unsigned char)(i * 7 + 3);
+    }
+    
+    for (size_t h = 0; h < sizeof(hashers) / sizeof(hashers[0]); h++) {
+        // Deterministic, and sensitive to the seed
+        ASSERT_EQ(hashers[h](buffer, 40, 0, NULL), hashers[h](buffer, 40, 0, NULL), "Hash should be deterministic");
+        ASSERT(hashers[h](buffer, 40, 0, NULL) != hashers[h](buffer, 40, 1, NULL), "Seed should change the hash");
+        
+        // Every prefix length (covering all tail paths) gets a different hash
+        size_t hashes[sizeof(buffer) + 1];
+        for (size_t len = 0; len <= sizeof(buffer); len++) {
+            hashes[len] = hashers[h](buffer, len, 42, NULL);
+            for (size_t prev = 0; prev < len; prev++) {
+                ASSERT(hashes[prev] != hashes[len], "Prefixes should hash differently");
+            }
+        }
+        
+        // A single flipped bit in the middle of a long key changes the hash
+        size_t before = hashers[h](buffer, 100, 0, NULL);
+        buffer[50] ^= 0x10;
+        ASSERT(before != hashers[h](buffer, 100, 0, NULL), "Flipped bit should change the hash");
+        buffer[50] ^= 0x10;
+    }
+    
+    // Seed 0 FNV-1a is the standard 64-bit FNV-1a
+    if (sizeof(size_t) == 8) {
+        ASSERT_EQ((size_t)0xCBF29CE484222325ull, hash_table_hash_fnv_1a("", 0, 0, NULL), "Empty key should hash to the offset basis");
+        ASSERT_EQ((size_t)0xAF63DC4C8601EC8Cull, hash_table_hash_fnv_1a("a", 1, 0, NULL), "FNV-1a of \"a\" should match the reference");
+    }
+}
+
+TEST(test_create_with_hasher) {
+    hash_function_t hashers[] = { NULL, hash_table_hash_fnv_1a, hash_table_hash_wyhash, hash_table_hash_crc32c, hash_table_hash_siphash };
+    char key[96];
+    
+    for (size_t h = 0; h < sizeof(hashers) / sizeof(hashers[0]); h++) {
+        hash_table_t *table = hash_table_create_with_hasher(hashers[h], NULL);
+        ASSERT_NOT_NULL(table, "Table with hasher should be created");
+        
+        for (int i = 0; i < 2000; i++) {
+            snprintf(key, sizeof(key), "tenant/%d/session/%08d/attribute", i % 7, i);
+            hash_table_insert_copy(table, SKEY(key), &i, sizeof(int));
+        }
+        ASSERT_EQ(2000, hash_table_size(table), "All keys should be inserted");
+        for (int i = 0; i < 2000; i++) {
+            snprintf(key, sizeof(key), "tenant/%d/session/%08d/attribute", i % 7, i);
+            int *retrieved = (int *)hash_table_get(table, SKEY(key));
+            ASSERT_NOT_NULL(retrieved, "Keys should be found after resizes");
+            ASSERT_EQ(i, *retrieved, "Values should be correct");
+        }
+        ASSERT_NULL(hash_table_get_string(table, "missing"), "Missing key should not be found");
+        
+        hash_table_destroy(table);
+    }
+}
+
+// Hashes only the first byte and counts its calls through the context pointer
+static size_t first_byte_hash(const void *key, size_t key_size, uint64_t seed, void *context) {
+    (void)seed;
+    (*(int *)context)++;
+    return key_size > 0 ? (size_t)((const unsigned char *)key)[0] * 0x9E3779B97F4A7C15ull : 0;
+}
+
+TEST(test_custom_hasher) {
+    int calls = 0;
+    hash_table_options_t options = hash_table_default_options();
+    options.hash_function = first_byte_hash;
+    options.hash_context = &calls;
+    options.seed = 1234;
+    hash_table_t *table = hash_table_create_with_options(&options);
+    
+    // Every key collides with the others, lookups still compare keys
+    char key[32];
+    for (int i = 0; i < 100; i++) {
+        snprintf(key, sizeof(key), "k%d", i);
+        hash_table_insert_copy(table, SKEY(key), &i, sizeof(int));
+    }
+    ASSERT(calls >= 100, "Custom hasher should be called with its context");
+    for (int i = 0; i < 100; i++) {
+        snprintf(key, sizeof(key), "k%d", i);
+        int *retrieved = (int *)hash_table_get(table, SKEY(key));
+        ASSERT_NOT_NULL(retrieved, "Colliding keys should be found");
+        ASSERT_EQ(i, *retrieved, "Values should be correct");
+    }
+    
+    hash_table_destroy(table);
+}
+
+// FNV-1a that counts its calls through the context pointer
+static size_t counting_hash(const void *key, size_t key_size, uint64_t seed, void *context) {
+    (*(int *)context)++;
+    return hash_table_hash_fnv_1a(key, key_size, seed, NULL);
+}
+
+TEST(test_prehashed_operations) {
+    int calls = 0;
+    hash_table_options_t options = hash_table_default_options();
+    options.hash_function = counting_hash;
+    options.hash_context = &calls;
+    options.random_seed = 1;
+    hash_table_t *table = hash_table_create_with_options(&options);
+    
+    char key[32];
+    size_t hashes[500];
+    for (int i = 0; i < 500; i++) {
+        snprintf(key, sizeof(key), "prehashed_key_%d", i);
+        hashes[i] = hash_table_hash(table, SKEY(key));
+    }
+    ASSERT_EQ(500, calls, "hash_table_hash should hash each key once");
+    
+    // Contains, then insert with the same hash, as a caller avoiding double hashing would
+    calls = 0;
+    for (int i = 0; i < 500; i++) {
+        snprintf(key, sizeof(key), "prehashed_key_%d", i);
+        ASSERT_EQ(0, hash_table_contains_prehashed(table, SKEY(key), hashes[i]), "New key should be missing");
+        ASSERT_EQ(0, hash_table_insert_copy_prehashed(table, SKEY(key), hashes[i], &i, sizeof(int)), "Insert should succeed");
+    }
+    for (int i = 0; i < 500; i += 2) {
+        snprintf(key, sizeof(key), "prehashed_key_%d", i);
+        hash_table_remove_prehashed(table, SKEY(key), hashes[i]);
+    }
+    int *value = malloc(sizeof(int));
+    *value = -1;
+    ASSERT_EQ(0, hash_table_insert_prehashed(table, SKEY("prehashed_key_1"), hashes[1], value), "Update should succeed");
+    ASSERT_EQ(0, calls, "Prehashed operations should not hash, even when resizing");
+    
+    // The regular functions find what the prehashed ones stored, and the other way around
+    for (int i = 0; i < 500; i++) {
+        snprintf(key, sizeof(key), "prehashed_key_%d", i);
+        int *retrieved = (int *)hash_table_get(table, SKEY(key));
+        ASSERT_EQ(retrieved, hash_table_get_prehashed(table, SKEY(key), hashes[i]), "Both lookups should agree");
+        if (i % 2 == 0) {
+            ASSERT_NULL(retrieved, "Removed keys should be gone");
+        } else {
+            ASSERT_NOT_NULL(retrieved, "Kept keys should be found");
+            ASSERT_EQ(i == 1 ? -1 : i, *retrieved, "Values should be correct");
+        }
+    }
+    ASSERT_EQ(0, hash_table_hash(NULL, SKEY("key")), "Hash of a NULL table should be 0");
+    ASSERT_NULL(hash_table_get_prehashed(NULL, SKEY("key"), 0), "Prehashed get on NULL table should return NULL");
+    
+    hash_table_destroy(table);
+}
+
+TEST(test_siphash_reference) {
+    // Reference values: SipHash-1-3 with an all-zero key (CPython's bytes hash with PYTHONHASHSEED=0)
+    hash_table_siphash_key_t zero_key = { 0, 0 };
+    ASSERT_EQ((size_t)13851880170939887858ull, hash_table_hash_siphash("abc", 3, 0, &zero_key), "SipHash-1-3 of \"abc\" should match the reference");
+    ASSERT_EQ((size_t)2013633222233385450ull, hash_table_hash_siphash("hello world, this is a longer key!", 34, 0, &zero_key), "SipHash-1-3 of a long key should match the reference");
+    
+    // The key from the context changes the hash, the seed is folded into it
+    hash_table_siphash_key_t other_key = { 1, 2 };
+    ASSERT(hash_table_hash_siphash("abc", 3, 0, &zero_key) != hash_table_hash_siphash("abc", 3, 0, &other_key), "Key should change the hash");
+    ASSERT_EQ(hash_table_hash_siphash("abc", 3, 1, &zero_key), hash_table_hash_siphash("abc", 3, 0, &(hash_table_siphash_key_t){ 1, 0 }), "Seed should be XORed into k0");
+}
+
+TEST(test_random_seed) {
+    ASSERT(hash_table_random_seed() != hash_table_random_seed(), "Random seeds should differ");
+    
+    hash_table_options_t options = hash_table_default_options();
+    options.hash_function = hash_table_hash_siphash;
+    options.random_seed = 1;
+    hash_table_t *a = hash_table_create_with_options(&options);
+    hash_table_t *b = hash_table_create_with_options(&options);
+    ASSERT(a->_seed != b->_seed, "Each table should get its own seed");
+    
+    for (int i = 0; i < 1000; i++) {
+        hash_table_insert_copy(a, &i, sizeof(int), &i, sizeof(int));
+    }
+    for (int i = 0; i < 1000; i++) {
+        int *retrieved = (int *)hash_table_get(a, &i, sizeof(int));
+        ASSERT_NOT_NULL(retrieved, "Keys should be found in a randomly seeded table");
+        ASSERT_EQ(i, *retrieved, "Values should be correct");
+    }
+    
+    hash_table_destroy(a);
+    hash_table_destroy(b);
+}
+
+// Every key collides under seed 0, as if an attacker had found collisions for it
+static size_t seed_zero_collision_hash(const void *key, size_t key_size, uint64_t seed, void *context) {
+    if (seed == 0) return 0x5555;
+    return hash_table_hash_siphash(key, key_size, seed, context);
+}
+
+TEST(test_reseed_on_long_probes) {
+    hash_table_probing_t policies[] = { HASH_TABLE_PROBING_LINEAR, HASH_TABLE_PROBING_ROBIN_HOOD };
+    
+    for (size_t p = 0; p < sizeof(policies) / sizeof(policies[0]); p++) {
+        hash_table_options_t options = hash_table_default_options();
+        options.hash_function = seed_zero_collision_hash;
+        options.probing = policies[p];
+        options.initial_capacity = 1024;
+        options.max_probe_length = 32;
+        hash_table_t *table = hash_table_create_with_options(&options);
+        ASSERT_EQ(0, table->_seed, "Table should start with the fixed seed");
+        
+        for (int i = 0; i < 400; i++) {
+            hash_table_insert_copy(table, &i, sizeof(int), &i, sizeof(int));
+        }
+        ASSERT(table->_seed != 0, "Long probes should reseed the table");
+        ASSERT_EQ(1024, hash_table_capacity(table), "Reseeding should not grow the table");
+        ASSERT_EQ(400, hash_table_size(table), "All keys should be inserted");
+        
+        for (int i = 0; i < 400; i++) {
+            int *retrieved = (int *)hash_table_get(table, &i, sizeof(int));
+            ASSERT_NOT_NULL(retrieved, "Keys should be found after reseeding");
+            ASSERT_EQ(i, *retrieved, "Values should be correct");
+        }
+        int missing = 400;
+        ASSERT_NULL(hash_table_get(table, &missing, sizeof(int)), "Missing key should not be found");
+        
+        hash_table_destroy(table);
+    }
+}
+
 // ========================================
 // Edge Cases Tests
 // ========================================
@@ -520,6 +1631,375 @@ TEST(test_mixed_key_sizes) {
     hash_table_destroy(table);
 }
 
+TEST(test_inline_key_boundary) {
+    // Keys of every length around HASH_TABLE_INLINE_KEY_SIZE, in both layouts
+    for (int layout = 0; layout < 2; layout++) {
+        hash_table_options_t options = hash_table_default_options();
+        options.layout = layout ? HASH_TABLE_LAYOUT_INTERLEAVED : HASH_TABLE_LAYOUT_SPLIT;
+        options.initial_capacity = 4;
+        hash_table_t *table = hash_table_create_with_options(&options);
+        
+        unsigned char key[HASH_TABLE_INLINE_KEY_SIZE * 2];
+        for (int len = 1; len <= (int)sizeof(key); len++) {
+            memset(key, 'x', sizeof(key));
+            key[len - 1] = (unsigned char)len;
+            hash_table_insert_copy(table, key, (size_t)len, &len, sizeof(int));
+        }
+        ASSERT_EQ(sizeof(key), hash_table_size(table), "All key lengths should be inserted");
+        
+        for (int len = 1; len <= (int)sizeof(key); len++) {
+            memset(key, 'x', sizeof(key));
+            key[len - 1] = (unsigned char)len;
+            int *retrieved = (int *)hash_table_get(table, key, (size_t)len);
+            ASSERT_NOT_NULL(retrieved, "Inline and heap keys should be found after resize");
+            ASSERT_EQ(len, *retrieved, "Values should match key length");
+            if (len % 2 == 0) {
+                hash_table_remove(table, key, (size_t)len);
+            }
+        }
+        ASSERT_EQ(sizeof(key) / 2, hash_table_size(table), "Half the keys should remain");
+        
+        hash_table_destroy(table);
+    }
+}
+
+// Case-insensitive string keys: hash and compare the lowercased bytes
+static size_t case_insensitive_hash(const void *key, size_t key_size, uint64_t seed, void *context) {
+    (void)context;
+    char lowered[64];
+    size_t size = key_size < sizeof(lowered) ? key_size : sizeof(lowered);
+    for (size_t i = 0; i < size; i++) {
+        lowered[i] = (char)tolower(((const unsigned char *)key)[i]);
+    }
+    return hash_table_hash_fnv_1a(lowered, size, seed, NULL);
+}
+
+static int case_insensitive_equal(const void *stored_key, size_t stored_key_size, const void *key, size_t key_size, void *context) {
+    (void)context;
+    if (stored_key_size != key_size) return 0;
+    for (size_t i = 0; i < key_size; i++) {
+        if (tolower(((const unsigned char *)stored_key)[i]) != tolower(((const unsigned char *)key)[i])) return 0;
+    }
+    return 1;
+}
+
+TEST(test_custom_key_equality) {
+    hash_table_options_t options = hash_table_default_options();
+    options.hash_function = case_insensitive_hash;
+    options.key_equal = case_insensitive_equal;
+    hash_table_t *table = hash_table_create_with_options(&options);
+    
+    int one = 1, two = 2;
+    hash_table_insert_copy_string(table, "Content-Type", &one, sizeof(int));
+    hash_table_insert_copy_string(table, "content-type", &two, sizeof(int));
+    ASSERT_EQ(1, hash_table_size(table), "Keys differing in case should be the same key");
+    
+    int *retrieved = (int *)hash_table_get_string(table, "CONTENT-TYPE");
+    ASSERT_NOT_NULL(retrieved, "Lookup should ignore case");
+    ASSERT_EQ(2, *retrieved, "Second insert should have updated the value");
+    ASSERT_NULL(hash_table_get_string(table, "Content-Length"), "Other keys should not match");
+    
+    hash_table_remove_string(table, "cOnTeNt-TyPe");
+    ASSERT_EQ(0, hash_table_size(table), "Remove should ignore case");
+    
+    hash_table_destroy(table);
+}
+
+// Keys that point to external strings: the table stores the pointer, hashing and
+// equality follow it to the string
+static size_t pointed_string_hash(const void *key, size_t key_size, uint64_t seed, void *context) {
+    (void)key_size;
+    (void)context;
+    const char *str;
+    memcpy(&str, key, sizeof(str));
+    return hash_table_hash_wyhash(str, strlen(str), seed, NULL);
+}
+
+static int pointed_string_equal(const void *stored_key, size_t stored_key_size, const void *key, size_t key_size, void *context) {
+    (void)stored_key_size;
+    (void)key_size;
+    (void)context;
+    const char *a;
+    const char *b;
+    memcpy(&a, stored_key, sizeof(a));
+    memcpy(&b, key, sizeof(b));
+    return strcmp(a, b) == 0;
+}
+
+TEST(test_external_data_keys) {
+    hash_table_options_t options = hash_table_default_options();
+    options.hash_function = pointed_string_hash;
+    options.key_equal = pointed_string_equal;
+    options.value_size = sizeof(int);
+    hash_table_t *table = hash_table_create_with_options(&options);
+    
+    static const char *const names[] = { "alpha", "beta", "gamma", "delta" };
+    for (int i = 0; i < 4; i++) {
+        hash_table_insert_copy(table, &names[i], sizeof(const char *), &i, sizeof(int));
+    }
+    
+    // Look up through different pointers to equal strings
+    char buffer[16];
+    for (int i = 0; i < 4; i++) {
+        strcpy(buffer, names[i]);
+        const char *lookup = buffer;
+        int *retrieved = (int *)hash_table_get(table, &lookup, sizeof(const char *));
+        ASSERT_NOT_NULL(retrieved, "Equal strings behind different pointers should match");
+        ASSERT_EQ(i, *retrieved, "Values should be correct");
+    }
+    strcpy(buffer, "epsilon");
+    const char *missing = buffer;
+    ASSERT_NULL(hash_table_get(table, &missing, sizeof(const char *)), "Other strings should not match");
+    
+    hash_table_destroy(table);
+}
+
+// Struct keys compared field by field, which needs stored keys to be aligned
+typedef struct {
+    double weights[3];
+    int64_t id;
+} test_weighted_key_t;
+
+static int aligned_key_misreads = 0;
+
+static int weighted_key_equal(const void *stored_key, size_t stored_key_size, const void *key, size_t key_size, void *context) {
+    (void)key_size;
+    (void)context;
+    if ((uintptr_t)stored_key % _Alignof(test_weighted_key_t) != 0) aligned_key_misreads++;
+    const test_weighted_key_t *a = stored_key;
+    const test_weighted_key_t *b = key;
+    return stored_key_size == sizeof(test_weighted_key_t) && a->id == b->id && a->weights[0] == b->weights[0];
+}
+
+TEST(test_key_arena) {
+    hash_table_options_t options = hash_table_default_options();
+    options.key_arena_chunk_size = 256;
+    options.key_equal = weighted_key_equal;
+    hash_table_t *table = hash_table_create_with_options(&options);
+    
+    for (int i = 0; i < 2000; i++) {
+        test_weighted_key_t key = { { i * 0.5, 1.0, 2.0 }, i };
+        hash_table_insert_copy(table, &key, sizeof(key), &i, sizeof(int));
+    }
+    // Removing most keys compacts the arena, moving the remaining keys
+    for (int i = 0; i < 2000; i++) {
+        if (i % 10 != 0) {
+            test_weighted_key_t key = { { i * 0.5, 1.0, 2.0 }, i };
+            hash_table_remove(table, &key, sizeof(key));
+        }
+    }
+    ASSERT_EQ(200, hash_table_size(table), "Size should be correct after removes");
+    for (int i = 0; i < 2000; i += 10) {
+        test_weighted_key_t key = { { i * 0.5, 1.0, 2.0 }, i };
+        int *retrieved = (int *)hash_table_get(table, &key, sizeof(key));
+        ASSERT_NOT_NULL(retrieved, "Remaining keys should survive compaction");
+        ASSERT_EQ(i, *retrieved, "Values should be correct after compaction");
+    }
+    ASSERT_EQ(0, aligned_key_misreads, "Arena keys should be aligned");
+    
+    // Live bytes are exactly the stored keys, rounded to the arena alignment
+    size_t live = 0;
+    hash_table_iter_t iter;
+    hash_table_iter_init(&iter, table);
+    while (hash_table_iter_next(&iter)) {
+        live += (iter.key_size + _Alignof(max_align_t) - 1) & ~(_Alignof(max_align_t) - 1);
+    }
+    ASSERT_EQ(live, table->_key_arena->live, "Arena should count only the stored keys after compaction");
+    ASSERT(table->_key_arena->dead < table->_key_arena->chunk_size || table->_key_arena->dead <= live,
+           "Removed keys should have been reclaimed");
+    
+    hash_table_destroy(table);
+    
+    // Keys larger than a chunk, and reuse after clear
+    char big_key[1000];
+    memset(big_key, 'b', sizeof(big_key));
+    options = hash_table_default_options();
+    options.key_arena_chunk_size = 256;
+    table = hash_table_create_with_options(&options);
+    hash_table_insert_copy_string(table, "a key that does not fit inline", &(int){1}, sizeof(int));
+    hash_table_insert_copy(table, big_key, sizeof(big_key), &(int){2}, sizeof(int));
+    hash_table_insert_copy_string(table, "another key that does not fit inline", &(int){3}, sizeof(int));
+    ASSERT_EQ(1, *(int *)hash_table_get_string(table, "a key that does not fit inline"), "Should retrieve arena keys");
+    ASSERT_EQ(2, *(int *)hash_table_get(table, big_key, sizeof(big_key)), "Should retrieve keys larger than a chunk");
+    ASSERT_EQ(3, *(int *)hash_table_get_string(table, "another key that does not fit inline"), "Should retrieve arena keys");
+    
+    hash_table_clear(table);
+    ASSERT_NULL(hash_table_get_string(table, "a key that does not fit inline"), "Clear should drop arena keys");
+    hash_table_insert_copy_string(table, "a key that does not fit inline", &(int){4}, sizeof(int));
+    ASSERT_EQ(4, *(int *)hash_table_get_string(table, "a key that does not fit inline"), "Arena should be reused after clear");
+    hash_table_destroy(table);
+}
+
+// ========================================
+// Integer Table Tests
+// ========================================
+
+TEST(test_u64_table) {
+    hash_table_u64_t *table = hash_table_u64_create();
+    ASSERT_NOT_NULL(table, "Table should be created");
+    
+    // Key 0 is the empty marker of the slot array but still a valid key
+    for (uint64_t i = 0; i < 5000; i++) {
+        ASSERT_EQ(0, hash_table_u64_insert(table, i * 0x9E3779B97F4A7C15ull, i), "Insert should succeed");
+    }
+    ASSERT_EQ(5000, hash_table_u64_size(table), "Size should count key 0 too");
+    ASSERT(hash_table_u64_capacity(table) >= 10000, "Table should have grown");
+    
+    hash_table_u64_insert(table, 0, 42);
+    ASSERT_EQ(5000, hash_table_u64_size(table), "Updating key 0 should not change the size");
+    ASSERT_EQ(42, *hash_table_u64_get(table, 0), "Key 0 should be updated");
+    
+    for (uint64_t i = 1; i < 5000; i++) {
+        uint64_t *value = hash_table_u64_get(table, i * 0x9E3779B97F4A7C15ull);
+        ASSERT_NOT_NULL(value, "Keys should be found");
+        ASSERT_EQ(i, *value, "Values should be correct");
+    }
+    ASSERT_NULL(hash_table_u64_get(table, 12345), "Missing key should not be found");
+    
+    // Remove every other key, the rest must stay reachable
+    for (uint64_t i = 0; i < 5000; i += 2) {
+        hash_table_u64_remove(table, i * 0x9E3779B97F4A7C15ull);
+    }
+    ASSERT_EQ(2500, hash_table_u64_size(table), "Half the keys should remain");
+    ASSERT(!hash_table_u64_contains(table, 0), "Key 0 should be removed");
+    for (uint64_t i = 1; i < 5000; i += 2) {
+        ASSERT(hash_table_u64_contains(table, i * 0x9E3779B97F4A7C15ull), "Odd keys should remain");
+        ASSERT(!hash_table_u64_contains(table, (i - 1) * 0x9E3779B97F4A7C15ull), "Even keys should be gone");
+    }
+    
+    hash_table_u64_clear(table);
+    ASSERT_EQ(0, hash_table_u64_size(table), "Clear should empty the table");
+    ASSERT(!hash_table_u64_contains(table, 0x9E3779B97F4A7C15ull), "Cleared keys should be gone");
+    
+    hash_table_u64_destroy(table);
+    
+    ASSERT_NULL(hash_table_u64_create_with_capacity(SIZE_MAX), "Capacities above the maximum should fail");
+    ASSERT_NULL(hash_table_u64_create_with_capacity(HASH_TABLE_MAX_CAPACITY + 1), "Capacities above the maximum should fail");
+}
+
+TEST(test_u32_table) {
+    hash_table_u32_t *table = hash_table_u32_create_with_capacity(100);
+    ASSERT_EQ(128, hash_table_u32_capacity(table), "Capacity should round up to a power of two");
+    
+    // Sequential keys, the worst case for a plain modulo index
+    for (uint32_t i = 0; i < 3000; i++) {
+        hash_table_u32_insert(table, i << 12, i);
+    }
+    for (uint32_t i = 0; i < 3000; i++) {
+        uint32_t *value = hash_table_u32_get(table, i << 12);
+        ASSERT_NOT_NULL(value, "Keys should be found");
+        ASSERT_EQ(i, *value, "Values should be correct");
+    }
+    
+    // Churn at a fixed size exercises backward-shift deletion
+    for (uint32_t i = 0; i < 3000; i++) {
+        hash_table_u32_remove(table, i << 12);
+        hash_table_u32_insert(table, (i + 3000) << 12, i);
+    }
+    ASSERT_EQ(3000, hash_table_u32_size(table), "Size should stay constant during churn");
+    for (uint32_t i = 0; i < 6000; i++) {
+        ASSERT_EQ(i >= 3000, hash_table_u32_contains(table, i << 12), "Only new keys should remain");
+    }
+    
+    hash_table_u32_destroy(table);
+    
+    ASSERT_NULL(hash_table_u32_create_with_capacity(SIZE_MAX), "Capacities above the maximum should fail");
+}
+
+// ========================================
+// Typed Table Tests
+// ========================================
+
+HT_DEFINE(typed_int_map, uint64_t, int, HT_HASH_INT, HT_EQ_SCALAR)
+HT_DEFINE(typed_str_map, const char *, size_t, HT_HASH_STR, HT_EQ_STR)
+
+typedef struct { int32_t x; int32_t y; } typed_point_t;
+HT_DEFINE(typed_point_map, typed_point_t, double, HT_HASH_BYTES, HT_EQ_BYTES)
+
+TEST(test_typed_int_table) {
+    typed_int_map_t *table = typed_int_map_create();
+    ASSERT_NOT_NULL(table, "Typed table should be created");
+    
+    for (int i = 0; i < 5000; i++) {
+        ASSERT_EQ(0, typed_int_map_insert(table, (uint64_t)i, i * 3), "Insert should succeed");
+    }
+    ASSERT_EQ(5000, typed_int_map_size(table), "Size should be correct");
+    ASSERT_EQ(16384, typed_int_map_capacity(table), "Table should grow by powers of two past the threshold");
+    
+    typed_int_map_insert(table, 7, -1);
+    ASSERT_EQ(-1, *typed_int_map_get(table, 7), "Insert should update an existing key");
+    ASSERT_NULL(typed_int_map_get(table, 5000), "Missing key should not be found");
+    
+    for (int i = 0; i < 5000; i += 2) {
+        typed_int_map_remove(table, (uint64_t)i);
+    }
+    ASSERT_EQ(2500, typed_int_map_size(table), "Half the keys should remain");
+    for (int i = 1; i < 5000; i += 2) {
+        int *value = typed_int_map_get(table, (uint64_t)i);
+        ASSERT_NOT_NULL(value, "Odd keys should remain");
+        ASSERT_EQ(i == 7 ? -1 : i * 3, *value, "Values should survive backward shifts");
+        ASSERT(!typed_int_map_contains(table, (uint64_t)(i - 1)), "Even keys should be gone");
+    }
+    
+    typed_int_map_clear(table);
+    ASSERT_EQ(0, typed_int_map_size(table), "Clear should empty the table");
+    ASSERT(!typed_int_map_contains(table, 1), "Cleared keys should be gone");
+    
+    typed_int_map_destroy(table);
+    
+    // Remove from a table with every slot full
+    table = typed_int_map_create_with_parameters(16, 1.0f, 2.0f);
+    for (int i = 0; i < 16; i++) {
+        typed_int_map_insert(table, (uint64_t)i, i);
+    }
+    ASSERT_EQ(16, typed_int_map_capacity(table), "Table should be full without growing");
+    typed_int_map_remove(table, 5);
+    ASSERT_EQ(15, typed_int_map_size(table), "Remove from a full table should succeed");
+    ASSERT(!typed_int_map_contains(table, 5), "Removed key should be gone");
+    for (int i = 0; i < 16; i++) {
+        if (i != 5) {
+            ASSERT_NOT_NULL(typed_int_map_get(table, (uint64_t)i), "Other keys should remain");
+        }
+    }
+    typed_int_map_destroy(table);
+    
+    // Capacities whose slots do not fit in a size_t fail instead of wrapping around
+    ASSERT_NULL(typed_int_map_create_with_parameters(SIZE_MAX, 0.5f, 2.0f), "Capacities above the maximum should fail");
+    ASSERT_NULL(typed_int_map_create_with_parameters(HASH_TABLE_MAX_CAPACITY, 0.5f, 2.0f), "Oversized slot arrays should fail");
+}
+
+TEST(test_typed_string_and_struct_tables) {
+    // String keys are compared by content, not by pointer
+    typed_str_map_t *strings = typed_str_map_create_with_parameters(4, 0.75f, 2.0f);
+    static const char *const words[] = { "apple", "banana", "cherry", "date", "elderberry", "fig" };
+    for (size_t i = 0; i < 6; i++) {
+        typed_str_map_insert(strings, words[i], i);
+    }
+    char buffer[16];
+    for (size_t i = 0; i < 6; i++) {
+        strcpy(buffer, words[i]);
+        size_t *value = typed_str_map_get(strings, buffer);
+        ASSERT_NOT_NULL(value, "Equal strings should match");
+        ASSERT_EQ(i, *value, "Values should be correct");
+    }
+    ASSERT(!typed_str_map_contains(strings, "grape"), "Other strings should not match");
+    typed_str_map_destroy(strings);
+    
+    typed_point_map_t *points = typed_point_map_create();
+    for (int32_t x = -20; x < 20; x++) {
+        for (int32_t y = -20; y < 20; y++) {
+            typed_point_t point = { x, y };
+            typed_point_map_insert(points, point, x * 100.0 + y);
+        }
+    }
+    ASSERT_EQ(1600, typed_point_map_size(points), "All points should be inserted");
+    typed_point_t probe = { -3, 17 };
+    double *value = typed_point_map_get(points, probe);
+    ASSERT_NOT_NULL(value, "Struct key should be found");
+    ASSERT(*value == -283.0, "Struct key value should be correct");
+    typed_point_map_destroy(points);
+}
+
 // ========================================
 // Stress Tests
 // ========================================
@@ -578,17 +2058,52 @@ int main(int argc, char *argv[]) {
     RUN_TEST(test_update_existing_key);
     RUN_TEST(test_get_nonexistent_key);
     RUN_TEST(test_contains);
+    RUN_TEST(test_get_batch);
+    RUN_TEST(test_insert_batch);
     
     printf("\nRemove Tests:\n");
     RUN_TEST(test_remove_existing_key);
     RUN_TEST(test_remove_nonexistent_key);
     RUN_TEST(test_remove_multiple);
+    RUN_TEST(test_remove_keeps_probe_chains);
+    RUN_TEST(test_probe_across_groups);
+    RUN_TEST(test_remove_churn);
+    RUN_TEST(test_remove_from_full_table);
     
     printf("\nClear Tests:\n");
     RUN_TEST(test_clear);
     
     printf("\nResize Tests:\n");
     RUN_TEST(test_resize);
+    RUN_TEST(test_resize_long_keys);
+    RUN_TEST(test_power_of_two_growth);
+    RUN_TEST(test_reserve);
+    RUN_TEST(test_shrink_to_fit);
+    RUN_TEST(test_shrink_on_low_load);
+    RUN_TEST(test_incremental_resize);
+    
+    printf("\nIteration Tests:\n");
+    RUN_TEST(test_iterator);
+    RUN_TEST(test_occupancy_bitmap);
+    RUN_TEST(test_scan_across_resize);
+    
+    printf("\nOptions Tests:\n");
+    RUN_TEST(test_create_with_options);
+    RUN_TEST(test_interleaved_layout);
+    RUN_TEST(test_fixed_value_size);
+    RUN_TEST(test_robin_hood_probing);
+    RUN_TEST(test_tombstone_deletion);
+    RUN_TEST(test_custom_allocator);
+    RUN_TEST(test_huge_pages);
+    
+    printf("\nHash Function Tests:\n");
+    RUN_TEST(test_builtin_hashers);
+    RUN_TEST(test_create_with_hasher);
+    RUN_TEST(test_custom_hasher);
+    RUN_TEST(test_prehashed_operations);
+    RUN_TEST(test_siphash_reference);
+    RUN_TEST(test_random_seed);
+    RUN_TEST(test_reseed_on_long_probes);
     
     printf("\nEdge Cases Tests:\n");
     RUN_TEST(test_null_table_operations);
@@ -606,6 +2121,18 @@ int main(int argc, char *argv[]) {
     RUN_TEST(test_integer_keys);
     RUN_TEST(test_struct_keys);
     RUN_TEST(test_mixed_key_sizes);
+    RUN_TEST(test_inline_key_boundary);
+    RUN_TEST(test_custom_key_equality);
+    RUN_TEST(test_external_data_keys);
+    RUN_TEST(test_key_arena);
+    
+    printf("\nInteger Table Tests:\n");
+    RUN_TEST(test_u64_table);
+    RUN_TEST(test_u32_table);
+    
+    printf("\nTyped Table Tests:\n");
+    RUN_TEST(test_typed_int_table);
+    RUN_TEST(test_typed_string_and_struct_tables);
     
     printf("\nStress Tests:\n");
     RUN_TEST(test_large_dataset);